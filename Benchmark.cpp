@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <iostream>
 
 #include <DaTrieDic.hpp>
@@ -52,20 +53,91 @@ void BenchmarkLookup(const DaTrieDic &dic, const std::vector<std::string> &strs)
   std::cout << "-> Time: " << ave_time / num_strs << " us per str" << std::endl;
 }
 
+void BenchmarkLookupBatch(const DaTrieDic &dic, const std::vector<std::string> &strs) {
+  auto num_strs = strs.size();
+  std::cout << "Batch lookup benchmark on " << RUNS << " runs" << std::endl;
+
+  std::vector<const char *> ptrs(num_strs);
+  for (size_t j = 0; j < num_strs; ++j) {
+    ptrs[j] = strs[j].c_str();
+  }
+  std::vector<uint32_t> ids(num_strs);
+
+  StopWatch sw;
+  for (size_t i = 0; i < RUNS; ++i) {
+    dic.lookup_batch(ptrs.data(), num_strs, ids.data());
+  }
+
+  auto ave_time = sw.get(sw_type::MICRO) / RUNS;
+  std::cout << "-> Time: " << ave_time / num_strs << " us per str" << std::endl;
+}
+
+void BenchmarkLookupSortedBatch(const DaTrieDic &dic, const std::vector<std::string> &strs) {
+  auto num_strs = strs.size();
+  std::cout << "Sorted batch lookup benchmark on " << RUNS << " runs" << std::endl;
+
+  std::vector<std::string_view> views(strs.begin(), strs.end());
+  std::sort(views.begin(), views.end());
+  std::vector<uint32_t> ids(num_strs);
+
+  StopWatch sw;
+  for (size_t i = 0; i < RUNS; ++i) {
+    dic.lookup_sorted_batch(views.data(), num_strs, ids.data());
+  }
+
+  auto ave_time = sw.get(sw_type::MICRO) / RUNS;
+  std::cout << "-> Time: " << ave_time / num_strs << " us per str" << std::endl;
+}
+
 void BenchmarkAccess(const DaTrieDic &dic, const std::vector<uint32_t> &ids) {
   auto num_ids = ids.size();
   std::cout << "Access benchmark on " << RUNS << " runs" << std::endl;
 
-  StopWatch sw;
-  for (size_t i = 0; i < RUNS; ++i) {
-    for (size_t j = 0; j < num_ids; ++j) {
-      std::string ret;
-      dic.access(ids[j], ret);
+  {
+    StopWatch sw;
+    for (size_t i = 0; i < RUNS; ++i) {
+      for (size_t j = 0; j < num_ids; ++j) {
+        std::string ret;
+        dic.access(ids[j], ret);
+      }
     }
+
+    auto ave_time = sw.get(sw_type::MICRO) / RUNS;
+    std::cout << "-> Time: " << ave_time / num_ids << " us per ID" << std::endl;
   }
 
-  auto ave_time = sw.get(sw_type::MICRO) / RUNS;
-  std::cout << "-> Time: " << ave_time / num_ids << " us per ID" << std::endl;
+  std::cout << "Access benchmark into buffer on " << RUNS << " runs" << std::endl;
+
+  {
+    std::vector<char> buf(dic.max_length());
+    size_t total_length = 0;
+
+    StopWatch sw;
+    for (size_t i = 0; i < RUNS; ++i) {
+      for (size_t j = 0; j < num_ids; ++j) {
+        total_length += dic.access(ids[j], buf.data(), buf.size());
+      }
+    }
+
+    auto ave_time = sw.get(sw_type::MICRO) / RUNS;
+    std::cout << "-> Time: " << ave_time / num_ids << " us per ID" << std::endl;
+    std::cout << "-> Length: " << total_length / RUNS << " bytes per run" << std::endl;
+  }
+
+  std::cout << "Batch access benchmark on " << RUNS << " runs" << std::endl;
+
+  {
+    std::string bytes;
+    std::vector<size_t> offsets;
+
+    StopWatch sw;
+    for (size_t i = 0; i < RUNS; ++i) {
+      dic.access_batch(ids.data(), num_ids, bytes, offsets);
+    }
+
+    auto ave_time = sw.get(sw_type::MICRO) / RUNS;
+    std::cout << "-> Time: " << ave_time / num_ids << " us per ID" << std::endl;
+  }
 }
 
 void ShowUsage(std::ostream &os) {
@@ -162,6 +234,8 @@ int main(int argc, const char *argv[]) {
       return -1;
     }
     BenchmarkLookup(dic, strs);
+    BenchmarkLookupBatch(dic, strs);
+    BenchmarkLookupSortedBatch(dic, strs);
     BenchmarkAccess(dic, ids);
   }
 
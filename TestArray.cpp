@@ -5,6 +5,7 @@
 
 #include <Array.hpp>
 #include <BitArray.hpp>
+#include <BlobArray.hpp>
 #include <SmallArray.hpp>
 
 namespace {
@@ -71,12 +72,30 @@ void TestSmallArray() {
   }
 }
 
+void TestBlobArray() {
+  std::vector<std::string> orig_array;
+  cda_tries::BlobArray blob_array;
+
+  std::random_device rnd;
+  for (uint32_t i = 0; i < SIZE; ++i) {
+    orig_array.push_back(std::string(rnd() % 8, static_cast<char>(rnd())));
+  }
+
+  blob_array.build(orig_array);
+  assert(blob_array.size() == orig_array.size());
+
+  for (uint32_t i = 0; i < SIZE; ++i) {
+    assert(blob_array[i] == orig_array[i]);
+  }
+}
+
 } // namespace
 
 int main() {
   TestArray();
   TestBitArray();
   TestSmallArray();
+  TestBlobArray();
 
   return 0;
 }
@@ -2,9 +2,17 @@
 
 #include <algorithm>
 #include <cassert>
+#include <cctype>
+#include <iterator>
 #include <random>
+#include <sstream>
 
+#include <AccessCache.hpp>
+#include <BasicDaTrieDic.hpp>
+#include <Cursor.hpp>
 #include <DaTrieDic.hpp>
+#include <Enumerator.hpp>
+#include <QueryExecutor.hpp>
 
 namespace {
 
@@ -48,6 +56,45 @@ void TestDaTrieDic(cda_tries::bc_type type, const std::vector<std::string> &strs
     std::string ret;
     dic.access(str_id, ret);
     assert(!ret.empty());
+
+    auto text = strs[i] + strs[i];
+    assert(dic.lookup(text.data(), strs[i].size()) == str_id);
+    assert(dic.lookup(std::string_view(text).substr(0, strs[i].size())) == str_id);
+    assert(dic.lookup(text.data(), strs[i].size() - 1)
+           == dic.lookup(strs[i].substr(0, strs[i].size() - 1).c_str()));
+    assert(dic.lookup(text) == dic.lookup(text.c_str()));
+  }
+
+  {
+    std::vector<std::string> queries(strs);
+    queries.push_back("");
+    queries.push_back(strs[0] + "#");
+    queries.push_back(strs[0].substr(0, strs[0].size() - 1));
+
+    std::vector<const char *> ptrs;
+    for (auto &query : queries) {
+      ptrs.push_back(query.c_str());
+    }
+    std::vector<uint32_t> ids(queries.size());
+    dic.lookup_batch(ptrs.data(), ptrs.size(), ids.data());
+
+    std::vector<std::string_view> views(queries.begin(), queries.end());
+    std::vector<uint32_t> view_ids(views.size());
+    dic.lookup_batch(views.data(), views.size(), view_ids.data());
+
+    for (size_t i = 0; i < queries.size(); ++i) {
+      assert(ids[i] == dic.lookup(queries[i].c_str()));
+      assert(view_ids[i] == ids[i]);
+    }
+
+    // The queries appended at the end are out of order.
+    dic.lookup_sorted_batch(ptrs.data(), ptrs.size(), ids.data());
+    std::sort(views.begin(), views.end());
+    dic.lookup_sorted_batch(views.data(), views.size(), view_ids.data());
+    for (size_t i = 0; i < queries.size(); ++i) {
+      assert(ids[i] == dic.lookup(queries[i].c_str()));
+      assert(view_ids[i] == dic.lookup(views[i]));
+    }
   }
 
   std::vector<uint32_t> ids;
@@ -55,18 +102,923 @@ void TestDaTrieDic(cda_tries::bc_type type, const std::vector<std::string> &strs
 
   assert(ids.size() == strs.size());
 
+  {
+    std::vector<uint32_t> batch_ids(ids);
+    batch_ids.push_back(cda_tries::NOT_FOUND);
+    batch_ids.push_back(batch_ids[0]);
+    std::string bytes;
+    std::vector<size_t> offsets;
+    dic.access_batch(batch_ids.data(), batch_ids.size(), bytes, offsets);
+    assert(offsets.size() == batch_ids.size() + 1);
+    for (size_t i = 0; i < batch_ids.size(); ++i) {
+      auto str = std::string_view(bytes).substr(offsets[i], offsets[i + 1] - offsets[i]);
+      assert(str == (i < strs.size() ? strs[i] : (i == strs.size() ? "" : strs[0])));
+    }
+
+    std::reverse(batch_ids.begin(), batch_ids.end());
+    dic.access_batch(batch_ids.data(), batch_ids.size(), bytes, offsets);
+    for (size_t i = 0; i < batch_ids.size(); i += 7) {
+      auto str = std::string_view(bytes).substr(offsets[i], offsets[i + 1] - offsets[i]);
+      assert(str == dic.access(batch_ids[i]));
+    }
+  }
+
+  std::vector<char> buf(dic.max_length());
   for (size_t i = 0; i < strs.size(); ++i) {
     std::string ret;
     dic.access(ids[i], ret);
     assert(ret == strs[i]);
+    assert(dic.access(ids[i]) == strs[i]);
+
+    auto length = dic.access(ids[i], buf.data(), buf.size());
+    assert(std::string(buf.data(), length) == strs[i]);
+    assert(dic.access(ids[i], buf.data(), length - 1) == length);
   }
 
+  size_t num_enumerated = 0;
+  dic.enumerate([&](uint32_t str_id, const std::string &str) {
+    assert(str_id == ids[num_enumerated]);
+    assert(str == strs[num_enumerated]);
+    return ++num_enumerated < strs.size() / 2;
+  });
+  assert(num_enumerated == strs.size() / 2);
+
   dic.clear();
   assert(dic.bc_size() == 0);
   assert(dic.tail_size() == 0);
   assert(dic.size_in_bytes() == 512);
   assert(dic.num_strs() == 0);
   assert(dic.max_length() == 0);
+  assert(dic.lookup("a") == cda_tries::NOT_FOUND);
+  assert(dic.lookup(std::string_view("a")) == cda_tries::NOT_FOUND);
+
+  cda_tries::DaTrieDic empty;
+  assert(empty.lookup("") == cda_tries::NOT_FOUND);
+  assert(empty.lookup(std::string_view()) == cda_tries::NOT_FOUND);
+}
+
+void TestCommonPrefixSearch(cda_tries::bc_type type, const std::vector<std::string> &strs) {
+  cda_tries::DaTrieDic dic;
+  dic.build(strs, type);
+
+  for (size_t i = 0; i + 1 < strs.size(); i += 97) {
+    auto text = strs[i] + strs[i + 1];
+
+    std::vector<cda_tries::match_t> matches;
+    dic.common_prefix_search(text.c_str(), text.size(), matches);
+
+    std::vector<cda_tries::match_t> expected;
+    for (size_t length = 0; length <= text.size(); ++length) {
+      auto str_id = dic.lookup(text.substr(0, length).c_str());
+      if (str_id != cda_tries::NOT_FOUND) {
+        expected.push_back(cda_tries::match_t{str_id, length});
+      }
+    }
+
+    assert(matches.size() == expected.size());
+    assert(!matches.empty());
+    for (size_t j = 0; j < matches.size(); ++j) {
+      assert(matches[j].str_id == expected[j].str_id);
+      assert(matches[j].length == expected[j].length);
+    }
+
+    auto longest = dic.longest_prefix_match(text.c_str(), text.size());
+    assert(longest.str_id == matches.back().str_id);
+    assert(longest.length == matches.back().length);
+  }
+}
+
+void TestLongestPrefixMatch(cda_tries::bc_type type, const std::vector<std::string> &strs) {
+  cda_tries::DaTrieDic dic;
+  dic.build(strs, type);
+
+  std::vector<std::string> texts;
+  for (size_t i = 0; i + 1 < strs.size(); i += 13) {
+    texts.push_back(strs[i] + strs[i + 1]);
+    texts.push_back(strs[i].substr(0, strs[i].size() / 2));
+  }
+  texts.push_back("");
+  texts.push_back("#");
+
+  std::vector<const char *> ptrs;
+  std::vector<size_t> lengths;
+  for (auto &text : texts) {
+    ptrs.push_back(text.c_str());
+    lengths.push_back(text.size());
+  }
+  std::vector<cda_tries::match_t> ret(texts.size());
+  dic.longest_prefix_match_batch(ptrs.data(), lengths.data(), texts.size(), ret.data());
+
+  for (size_t i = 0; i < texts.size(); ++i) {
+    auto longest = dic.longest_prefix_match(texts[i].c_str(), texts[i].size());
+    assert(ret[i].str_id == longest.str_id);
+    assert(ret[i].length == longest.length);
+    if (longest.str_id != cda_tries::NOT_FOUND) {
+      assert(dic.lookup(texts[i].substr(0, longest.length).c_str()) == longest.str_id);
+    }
+  }
+}
+
+void TestPredictiveSearch(cda_tries::bc_type type, const std::vector<std::string> &strs) {
+  cda_tries::DaTrieDic dic;
+  dic.build(strs, type);
+
+  for (size_t i = 0; i < strs.size(); i += 997) {
+    for (size_t length = 1; length <= strs[i].size(); length += 3) {
+      auto prefix = strs[i].substr(0, length);
+      auto it = std::lower_bound(strs.begin(), strs.end(), prefix);
+
+      auto num_keys = dic.predictive_search(prefix.c_str(), [&](uint32_t str_id,
+                                                                const std::string &str) {
+        assert(it != strs.end() && *it == str);
+        assert(dic.lookup(str.c_str()) == str_id);
+        ++it;
+        return true;
+      });
+      assert(num_keys != 0);
+      assert(it == strs.end() || it->compare(0, length, prefix) != 0);
+
+      size_t count = 0;
+      auto limited = dic.predictive_search(prefix.c_str(), [&](uint32_t, const std::string &) {
+        return ++count < 2;
+      }, 3);
+      assert(limited == std::min<size_t>(num_keys, 2));
+      assert(count == limited);
+    }
+  }
+
+  assert(dic.predictive_search("#", [](uint32_t, const std::string &) {
+    return true;
+  }) == 0);
+  assert(dic.predictive_search("", [](uint32_t, const std::string &) {
+    return true;
+  }) == strs.size());
+}
+
+size_t EditDistance(const std::string &a, const std::string &b) {
+  std::vector<size_t> row(b.size() + 1);
+  for (size_t j = 0; j <= b.size(); ++j) {
+    row[j] = j;
+  }
+  for (size_t i = 1; i <= a.size(); ++i) {
+    auto diag = row[0];
+    row[0] = i;
+    for (size_t j = 1; j <= b.size(); ++j) {
+      auto up = row[j];
+      row[j] = std::min({row[j] + 1, row[j - 1] + 1, diag + (a[i - 1] != b[j - 1])});
+      diag = up;
+    }
+  }
+  return row[b.size()];
+}
+
+void TestCountPrefix(cda_tries::bc_type type, const std::vector<std::string> &strs) {
+  cda_tries::DaTrieDic dic;
+  dic.build(strs, type);
+
+  auto test = [&]() {
+    for (size_t i = 0; i < strs.size(); i += 997) {
+      for (size_t length = 0; length <= strs[i].size(); length += 2) {
+        auto prefix = strs[i].substr(0, length);
+        auto first = std::lower_bound(strs.begin(), strs.end(), prefix);
+        auto last = first;
+        while (last != strs.end() && last->compare(0, length, prefix) == 0) {
+          ++last;
+        }
+        assert(dic.count_prefix(prefix) == static_cast<size_t>(last - first));
+      }
+      assert(dic.count_prefix(strs[i] + "#") == 0);
+    }
+  };
+
+  test();
+  auto size_in_bytes = dic.size_in_bytes();
+  dic.build_count_index();
+  assert(size_in_bytes < dic.size_in_bytes());
+  test();
+
+  std::stringstream ss;
+  dic.write(ss);
+  dic.read(ss, type);
+  assert(dic.count_prefix("") == strs.size());
+}
+
+void TestRange(cda_tries::bc_type type, const std::vector<std::string> &strs) {
+  cda_tries::DaTrieDic dic;
+  dic.build(strs, type);
+
+  auto id_of = [&](std::vector<std::string>::const_iterator it) {
+    return it == strs.end() ? cda_tries::NOT_FOUND : dic.lookup(*it);
+  };
+
+  std::vector<std::string> keys = {"", "#", "~", strs.back() + "#"};
+  for (size_t i = 0; i < strs.size(); i += 997) {
+    keys.push_back(strs[i]);
+    keys.push_back(strs[i] + "#");
+    keys.push_back(strs[i].substr(0, strs[i].size() / 2));
+    keys.push_back(strs[i].substr(0, strs[i].size() - 1) + "~");
+  }
+
+  for (auto &key : keys) {
+    assert(dic.lower_bound(key) == id_of(std::lower_bound(strs.begin(), strs.end(), key)));
+    assert(dic.upper_bound(key) == id_of(std::upper_bound(strs.begin(), strs.end(), key)));
+  }
+
+  for (size_t i = 0; i + 1 < keys.size(); ++i) {
+    auto lo = std::min(keys[i], keys[i + 1]);
+    auto hi = std::max(keys[i], keys[i + 1]);
+    auto it = std::lower_bound(strs.begin(), strs.end(), lo);
+    auto count = dic.range(lo, hi, [&](uint32_t str_id, const std::string &str) {
+      assert(*it == str && dic.lookup(str) == str_id);
+      ++it;
+      return true;
+    });
+    assert(it == std::lower_bound(strs.begin(), strs.end(), hi));
+    assert(dic.range(lo, hi, [](uint32_t, const std::string &) {
+      return true;
+    }, 5) == std::min<size_t>(count, 5));
+  }
+}
+
+void TestTopkCompletions(cda_tries::bc_type type, const std::vector<std::string> &strs) {
+  cda_tries::DaTrieDic dic;
+  dic.build(strs, type);
+
+  std::random_device rnd;
+  std::vector<uint32_t> weights(strs.size());
+  for (auto &weight : weights) {
+    weight = rnd() % 1000;
+  }
+  dic.build_count_index();
+  dic.build_weights(weights);
+
+  std::stringstream ss;
+  dic.write(ss);
+  dic.read(ss, type);
+
+  auto check = [&]() {
+    for (size_t i = 0; i < strs.size(); i += 997) {
+      for (size_t length = 1; length <= 3; ++length) {
+        auto prefix = strs[i].substr(0, length);
+        std::vector<uint32_t> expected;
+        dic.predictive_search(prefix, [&](uint32_t str_id, const std::string &) {
+          expected.push_back(weights[str_id]);
+          return true;
+        });
+        std::sort(expected.rbegin(), expected.rend());
+        expected.resize(std::min<size_t>(expected.size(), 10));
+
+        std::vector<cda_tries::weighted_t> ret;
+        dic.topk_completions(prefix, 10, ret);
+        assert(ret.size() == expected.size());
+        for (size_t j = 0; j < ret.size(); ++j) {
+          assert(ret[j].weight == expected[j]);
+          assert(ret[j].weight == weights[ret[j].str_id]);
+          assert(dic.access(ret[j].str_id).substr(0, prefix.size()) == prefix);
+        }
+      }
+    }
+  };
+  check();
+
+  // Expanded through the child index
+  dic.build_child_index();
+  check();
+
+  auto sorted_weights = weights;
+  std::sort(sorted_weights.rbegin(), sorted_weights.rend());
+  std::vector<cda_tries::weighted_t> ret;
+  dic.topk_completions("", 10, ret);
+  for (size_t j = 0; j < ret.size(); ++j) {
+    assert(ret[j].weight == sorted_weights[j]);
+  }
+  assert(dic.count_prefix("") == strs.size());
+
+  // The root of a single key is a leaf without max_weights_.
+  dic.build({"abc"}, type);
+  dic.build_weights({7});
+  dic.topk_completions("ab", 10, ret);
+  assert(ret.size() == 1 && ret[0].str_id == 0 && ret[0].weight == 7);
+  dic.topk_completions("b", 10, ret);
+  assert(ret.empty());
+}
+
+void TestSetOperations(cda_tries::bc_type type, const std::vector<std::string> &strs) {
+  std::vector<std::string> lhs_strs, rhs_strs;
+  for (size_t i = 0; i < strs.size(); ++i) {
+    if (i % 3 != 0) {
+      lhs_strs.push_back(strs[i]);
+    }
+    if (i % 2 != 0) {
+      rhs_strs.push_back(strs[i]);
+    }
+  }
+
+  cda_tries::DaTrieDic lhs, rhs;
+  lhs.build(lhs_strs, type);
+  rhs.build(rhs_strs, cda_tries::bc_type::DAC);
+
+  std::vector<std::string> expected, results;
+  std::set_intersection(lhs_strs.begin(), lhs_strs.end(), rhs_strs.begin(), rhs_strs.end(),
+                        std::back_inserter(expected));
+  lhs.intersect(rhs, [&](uint32_t lhs_id, uint32_t rhs_id) {
+    results.emplace_back(lhs.access(lhs_id));
+    assert(rhs.access(rhs_id) == results.back());
+  });
+  assert(results == expected);
+
+  expected.clear();
+  results.clear();
+  std::set_difference(lhs_strs.begin(), lhs_strs.end(), rhs_strs.begin(), rhs_strs.end(),
+                      std::back_inserter(expected));
+  lhs.difference(rhs, [&](uint32_t lhs_id) {
+    results.emplace_back(lhs.access(lhs_id));
+  });
+  assert(results == expected);
+
+  expected.clear();
+  results.clear();
+  std::set_union(lhs_strs.begin(), lhs_strs.end(), rhs_strs.begin(), rhs_strs.end(),
+                 std::back_inserter(expected));
+  lhs.merge(rhs, [&](uint32_t lhs_id, uint32_t rhs_id) {
+    assert(lhs_id != cda_tries::NOT_FOUND || rhs_id != cda_tries::NOT_FOUND);
+    if (lhs_id != cda_tries::NOT_FOUND && rhs_id != cda_tries::NOT_FOUND) {
+      std::string lhs_str(lhs.access(lhs_id));
+      assert(lhs_str == rhs.access(rhs_id));
+    }
+    results.emplace_back(lhs_id != cda_tries::NOT_FOUND ? lhs.access(lhs_id)
+                                                        : rhs.access(rhs_id));
+  });
+  assert(results == expected);
+
+  // One side walks the child index and the other probes the labels.
+  rhs.build_child_index();
+  results.clear();
+  lhs.merge(rhs, [&](uint32_t lhs_id, uint32_t rhs_id) {
+    results.emplace_back(lhs_id != cda_tries::NOT_FOUND ? lhs.access(lhs_id)
+                                                        : rhs.access(rhs_id));
+  });
+  assert(results == expected);
+
+  cda_tries::DaTrieDic empty;
+  size_t count = 0;
+  lhs.difference(empty, [&](uint32_t) {
+    ++count;
+  });
+  assert(count == lhs_strs.size());
+  empty.intersect(lhs, [&](uint32_t, uint32_t) {
+    assert(false);
+  });
+}
+
+void TestScan(cda_tries::bc_type type, const std::vector<std::string> &strs) {
+  cda_tries::DaTrieDic dic;
+  dic.build(strs, type);
+
+  std::string text;
+  for (size_t i = 0; i < strs.size(); i += 331) {
+    text += strs[i].substr(strs[i].size() / 3);
+  }
+
+  bool folded = false;
+  auto collect = [&](std::vector<std::pair<size_t, uint32_t>> &ret) {
+    ret.clear();
+    dic.scan(text, [&](const cda_tries::match_t &match) {
+      assert(match.length <= text.size());
+      std::string str(dic.access(match.str_id));
+      auto occurrence = text.substr(match.length - str.size(), str.size());
+      if (folded) {
+        std::transform(occurrence.begin(), occurrence.end(), occurrence.begin(), ::tolower);
+      }
+      assert(occurrence == str);
+      ret.emplace_back(match.length, match.str_id);
+    });
+  };
+
+  std::vector<std::pair<size_t, uint32_t>> expected, results;
+  collect(expected);
+  std::sort(expected.begin(), expected.end());
+  assert(!expected.empty());
+
+  dic.build_scanner();
+  std::stringstream ss;
+  dic.write(ss);
+  dic.read(ss, type);
+  collect(results);
+  assert(std::is_sorted(results.begin(), results.end(), [](const auto &lhs, const auto &rhs) {
+    return lhs.first < rhs.first;
+  }));
+  std::sort(results.begin(), results.end());
+  assert(results == expected);
+
+  dic.build({"he", "hers", "his", "she"}, type, cda_tries::id_order::LEX,
+            cda_tries::AsciiCaseFoldMap());
+  dic.build_scanner();
+  folded = true;
+  text = "ushers";
+  collect(results);
+  assert((results == std::vector<std::pair<size_t, uint32_t>>{{4, 3}, {4, 0}, {6, 1}}));
+  text = "UsHErs his";
+  collect(results);
+  assert((results == std::vector<std::pair<size_t, uint32_t>>{{4, 3}, {4, 0}, {6, 1}, {10, 2}}));
+
+  // The empty key is reported at every offset by both paths.
+  folded = false;
+  text = "aab";
+  dic.build({"", "a", "ab"}, type);
+  collect(expected);
+  std::sort(expected.begin(), expected.end());
+  dic.build_scanner();
+  collect(results);
+  std::sort(results.begin(), results.end());
+  assert(results == expected);
+  assert((results == std::vector<std::pair<size_t, uint32_t>>{
+    {0, 0}, {1, 0}, {1, 1}, {2, 0}, {2, 1}, {3, 0}, {3, 2}}));
+}
+
+void TestCursor(cda_tries::bc_type type, const std::vector<std::string> &strs) {
+  cda_tries::DaTrieDic dic;
+  dic.build(strs, type);
+
+  for (size_t i = 0; i < strs.size(); i += 997) {
+    cda_tries::Cursor cursor(dic);
+    for (size_t length = 1; length <= strs[i].size(); ++length) {
+      assert(cursor.feed(strs[i][length - 1]));
+      auto prefix = strs[i].substr(0, length);
+      assert(cursor.id() == dic.lookup(prefix));
+
+      if (length <= 3 || length == strs[i].size()) {
+        std::vector<std::pair<uint32_t, std::string>> expected, results;
+        dic.predictive_search(prefix, [&](uint32_t str_id, const std::string &str) {
+          expected.emplace_back(str_id, str);
+          return true;
+        });
+        cursor.predict([&](uint32_t str_id, const std::string &str) {
+          results.emplace_back(str_id, str);
+          return true;
+        });
+        assert(results == expected);
+      }
+    }
+    assert(cursor.is_terminal());
+
+    auto copy = cursor;
+    copy.feed('#');
+    assert(!copy.is_valid() && !copy.is_terminal());
+    assert(copy.predict([](uint32_t, const std::string &) {
+      return true;
+    }) == 0);
+    assert(cursor.is_terminal());
+
+    cursor.reset();
+    assert(cursor.feed(strs[i]) && cursor.id() == dic.lookup(strs[i]));
+  }
+}
+
+void TestEnumerator(cda_tries::bc_type type, const std::vector<std::string> &strs) {
+  cda_tries::DaTrieDic dic;
+  dic.build(strs, type);
+
+  std::vector<uint32_t> expected, results;
+  dic.enumerate(expected);
+
+  auto paginate = [&]() {
+    results.clear();
+    std::string token = cda_tries::Enumerator(dic).token();
+    while (true) {
+      cda_tries::Enumerator enumerator(dic, token);
+      if (enumerator.is_end()) {
+        break;
+      }
+      auto size = results.size();
+      assert(enumerator.next(1000, results) == results.size() - size);
+      token = enumerator.token();
+    }
+  };
+  paginate();
+  assert(results == expected);
+
+  // The traversals follow the labels of the children with the index.
+  dic.build_child_index();
+  std::stringstream ss;
+  dic.write(ss);
+  dic.read(ss, type);
+  dic.enumerate(results);
+  assert(results == expected);
+  paginate();
+  assert(results == expected);
+  for (size_t i = 0; i < strs.size(); i += 997) {
+    auto prefix = strs[i].substr(0, 2);
+    size_t count = 0;
+    dic.predictive_search(prefix, [&](uint32_t str_id, const std::string &str) {
+      assert(str.compare(0, prefix.size(), prefix) == 0 && dic.lookup(str) == str_id);
+      ++count;
+      return true;
+    });
+    assert(count == static_cast<size_t>(std::count_if(strs.begin(), strs.end(), [&](auto &str) {
+      return str.compare(0, prefix.size(), prefix) == 0;
+    })));
+  }
+
+  cda_tries::Enumerator enumerator(dic);
+  size_t count = 0;
+  assert(enumerator.next(10, [&](uint32_t str_id, const std::string &str) {
+    assert(str_id == expected[count] && str == strs[count]);
+    return ++count != 3;
+  }) == 3);
+  results.clear();
+  enumerator.next(1, results);
+  assert(results.size() == 1 && results[0] == expected[3]);
+
+  assert(cda_tries::Enumerator(dic, "").is_end());
+  assert(cda_tries::Enumerator(dic, std::string(4, '\xff')).is_end());
+  assert(cda_tries::Enumerator(cda_tries::DaTrieDic()).is_end());
+}
+
+void TestFuzzySearch(cda_tries::bc_type type, const std::vector<std::string> &strs) {
+  cda_tries::DaTrieDic dic;
+  dic.build(strs, type);
+
+  for (size_t i = 0; i < strs.size(); i += 4999) {
+    auto query = strs[i].substr(0, 6);
+    query[query.size() / 2] = '#';
+    for (size_t k = 0; k <= 2; ++k) {
+      std::vector<std::string> expected;
+      for (auto &str : strs) {
+        if (EditDistance(str, query) <= k) {
+          expected.push_back(str);
+        }
+      }
+      std::vector<std::string> results;
+      dic.fuzzy_search(query, k, [&](uint32_t str_id, const std::string &str,
+                                     size_t distance) {
+        assert(dic.lookup(str) == str_id);
+        assert(distance == EditDistance(str, query));
+        results.push_back(str);
+        return true;
+      });
+      assert(results == expected);
+    }
+  }
+
+  assert(dic.fuzzy_search(strs[0], 0, [](uint32_t, const std::string &, size_t) {
+    return true;
+  }) == 1);
+  // A long query with a narrow band
+  for (size_t i = 0; i < strs.size(); i += 4099) {
+    auto query = strs[i];
+    query[query.size() / 2] = '#';
+    bool found = false;
+    dic.fuzzy_search(query, 1, [&](uint32_t, const std::string &str, size_t distance) {
+      assert(distance <= 1 && distance == EditDistance(str, query));
+      found |= str == strs[i];
+      return true;
+    });
+    assert(found);
+  }
+  // Every key is within SIZE_MAX.
+  assert(dic.fuzzy_search("a", SIZE_MAX, [](uint32_t, const std::string &, size_t) {
+    return true;
+  }) == strs.size());
+}
+
+void TestPattern() {
+  cda_tries::Pattern pattern;
+
+  assert(pattern.build_glob("a?c*"));
+  assert(pattern.match("abc") && pattern.match("aXcdef") && !pattern.match("ac"));
+  assert(pattern.build_glob("\\*x"));
+  assert(pattern.match("*x") && !pattern.match("ax"));
+
+  assert(pattern.build_regex("(ab|c)+[0-9]?d*"));
+  assert(pattern.match("ab") && pattern.match("cab5dd") && !pattern.match("a5"));
+  assert(pattern.build_regex("[^a-c]\\.x"));
+  assert(pattern.match("d.x") && !pattern.match("a.x") && !pattern.match("dyx"));
+  assert(pattern.build_regex("") && pattern.match("") && !pattern.match("a"));
+
+  auto fold_map = cda_tries::AsciiCaseFoldMap();
+  assert(pattern.build_glob("Ap*", fold_map));
+  assert(pattern.match("apple") && pattern.match("APPLE") && !pattern.match("bp"));
+  assert(pattern.build_regex("[B-Y]z", fold_map));
+  assert(pattern.match("bZ") && pattern.match("Yz") && !pattern.match("az"));
+
+  assert(!pattern.build_regex("(ab"));
+  assert(!pattern.build_regex("*a"));
+  assert(!pattern.build_regex("[z-a]"));
+  assert(pattern.num_states() == 0 && !pattern.match(""));
+}
+
+void TestPatternSearch(cda_tries::bc_type type, const std::vector<std::string> &strs) {
+  cda_tries::DaTrieDic dic;
+  dic.build(strs, type);
+
+  auto test = [&](const cda_tries::Pattern &pattern) {
+    std::vector<std::string> expected;
+    for (auto &str : strs) {
+      if (pattern.match(str)) {
+        expected.push_back(str);
+      }
+    }
+    std::vector<std::string> results;
+    dic.pattern_search(pattern, [&](uint32_t str_id, const std::string &str) {
+      assert(dic.lookup(str) == str_id);
+      results.push_back(str);
+      return true;
+    });
+    assert(results == expected);
+  };
+
+  cda_tries::Pattern pattern;
+  for (size_t i = 0; i < strs.size(); i += 4999) {
+    auto glob = strs[i].substr(0, 3) + "*" + strs[i].substr(strs[i].size() - 1);
+    assert(pattern.build_glob(glob));
+    test(pattern);
+    assert(pattern.build_glob(strs[i].substr(0, 2) + "??*"));
+    test(pattern);
+  }
+  assert(pattern.build_regex("[a-c]([A-Z]|x)+.?"));
+  test(pattern);
+  assert(pattern.build_regex(".*"));
+  assert(dic.pattern_search(pattern, [](uint32_t, const std::string &) {
+    return true;
+  }) == strs.size());
+}
+
+void TestDeepEnumerate(cda_tries::bc_type type) {
+  std::string prefix(1U << 12, 'a');
+  std::vector<std::string> strs = {prefix, prefix + "b", prefix + "c", "b"};
+
+  cda_tries::DaTrieDic dic;
+  dic.build(strs, type);
+
+  std::vector<uint32_t> ids;
+  dic.enumerate(ids);
+  assert(ids.size() == strs.size());
+  for (size_t i = 0; i < strs.size(); ++i) {
+    assert(dic.lookup(strs[i]) == ids[i]);
+  }
+}
+
+// Every value in the elements of a small dictionary fits in a byte.
+void TestSmallIO(cda_tries::bc_type type) {
+  std::vector<std::string> strs = {"ab", "ac", "b"};
+
+  cda_tries::DaTrieDic dic;
+  dic.build(strs, type);
+  std::stringstream ss;
+  dic.write(ss);
+  dic.read(ss, type);
+
+  for (size_t i = 0; i < strs.size(); ++i) {
+    auto str_id = dic.lookup(strs[i]);
+    assert(str_id != cda_tries::NOT_FOUND && dic.access(str_id) == strs[i]);
+  }
+  assert(dic.lookup("a") == cda_tries::NOT_FOUND);
+
+  // Only the empty key, where max_length is 0
+  dic.build(std::vector<std::string>{""}, type);
+  assert(dic.max_length() == 0);
+  assert(dic.lookup("") == 0 && dic.access(0).empty());
+}
+
+void TestLexIds(cda_tries::bc_type type, const std::vector<std::string> &strs) {
+  cda_tries::DaTrieDic dic;
+  dic.build(strs, type, cda_tries::id_order::LEX);
+  assert(dic.order() == cda_tries::id_order::LEX);
+
+  std::stringstream ss;
+  dic.write(ss);
+  dic.read(ss, type);
+  assert(dic.order() == cda_tries::id_order::LEX);
+
+  for (uint32_t i = 0; i < strs.size(); ++i) {
+    assert(dic.lookup(strs[i]) == i);
+    assert(dic.access(i) == strs[i]);
+  }
+
+  std::vector<uint32_t> ids;
+  dic.enumerate(ids);
+  for (uint32_t i = 0; i < ids.size(); ++i) {
+    assert(ids[i] == i);
+  }
+
+  for (size_t i = 0; i < strs.size(); i += 997) {
+    auto prefix = strs[i].substr(0, 2);
+    auto first = static_cast<uint32_t>(std::lower_bound(strs.begin(), strs.end(), prefix)
+                                       - strs.begin());
+    dic.predictive_search(prefix, [&](uint32_t str_id, const std::string &) {
+      assert(str_id == first++);
+      return true;
+    });
+  }
+}
+
+void TestCaseFolding(cda_tries::bc_type type, const std::vector<std::string> &strs) {
+  auto fold_map = cda_tries::AsciiCaseFoldMap();
+  auto fold = [&](std::string str) {
+    for (auto &c : str) {
+      c = static_cast<char>(fold_map[static_cast<uint8_t>(c)]);
+    }
+    return str;
+  };
+  auto flip = [](std::string str) {
+    for (auto &c : str) {
+      c = static_cast<char>(std::islower(c) ? std::toupper(c) : std::tolower(c));
+    }
+    return str;
+  };
+
+  std::vector<std::string> folded_strs;
+  for (auto &str : strs) {
+    folded_strs.push_back(fold(str));
+  }
+  std::sort(folded_strs.begin(), folded_strs.end());
+  folded_strs.erase(std::unique(folded_strs.begin(), folded_strs.end()), folded_strs.end());
+
+  cda_tries::DaTrieDic dic;
+  dic.build(strs, type, cda_tries::id_order::LEX, fold_map);
+  assert(dic.num_strs() == folded_strs.size());
+
+  std::vector<std::string> queries;
+  for (size_t i = 0; i < strs.size(); ++i) {
+    auto str_id = dic.lookup(strs[i]);
+    assert(str_id == std::lower_bound(folded_strs.begin(), folded_strs.end(),
+                                      fold(strs[i])) - folded_strs.begin());
+    assert(dic.lookup(flip(strs[i]).c_str()) == str_id);
+    assert(dic.access(str_id) == fold(strs[i]));
+    assert(dic.longest_prefix_match(flip(strs[i]) + "#").str_id == str_id);
+    queries.push_back(flip(strs[i]));
+  }
+
+  std::vector<std::string_view> views(queries.begin(), queries.end());
+  std::vector<uint32_t> ids(views.size());
+  dic.lookup_batch(views.data(), views.size(), ids.data());
+  for (size_t i = 0; i < views.size(); ++i) {
+    assert(ids[i] == dic.lookup(strs[i]));
+  }
+
+  for (size_t i = 0; i < strs.size(); i += 997) {
+    auto prefix = flip(strs[i].substr(0, 3));
+    auto it = std::lower_bound(folded_strs.begin(), folded_strs.end(), fold(prefix));
+    dic.predictive_search(prefix, [&](uint32_t, const std::string &str) {
+      assert(*it++ == str);
+      return true;
+    });
+    assert(it == folded_strs.end() || it->compare(0, 3, fold(prefix)) != 0);
+  }
+
+  cda_tries::Pattern pattern;
+  for (size_t i = 0; i < strs.size(); i += 997) {
+    auto prefix = flip(strs[i].substr(0, 3));
+    assert(pattern.build_glob(prefix + "*", fold_map));
+    auto it = std::lower_bound(folded_strs.begin(), folded_strs.end(), fold(prefix));
+    dic.pattern_search(pattern, [&](uint32_t, const std::string &str) {
+      assert(*it++ == str);
+      return true;
+    });
+    assert(it == folded_strs.end() || it->compare(0, 3, fold(prefix)) != 0);
+  }
+
+  std::vector<uint32_t> enumerated;
+  dic.enumerate(enumerated);
+  assert(enumerated.size() == folded_strs.size());
+}
+
+void TestValues(cda_tries::bc_type type, const std::vector<std::string> &strs) {
+  cda_tries::DaTrieDic dic;
+  dic.build(strs, type);
+
+  std::vector<uint32_t> values(strs.size());
+  std::vector<std::string> blobs(strs.size());
+  for (size_t i = 0; i < strs.size(); ++i) {
+    auto str_id = dic.lookup(strs[i]);
+    values[str_id] = static_cast<uint32_t>(strs[i].size() * 3);
+    blobs[str_id] = strs[i].substr(0, i % 5);
+  }
+  dic.set_values(values);
+  dic.set_blobs(blobs);
+
+  std::stringstream ss;
+  dic.write(ss);
+  dic.read(ss, type);
+
+  for (size_t i = 0; i < strs.size(); ++i) {
+    uint32_t value = 0;
+    std::string_view blob;
+    auto str_id = dic.lookup_value(strs[i], value);
+    assert(str_id == dic.lookup(strs[i]));
+    assert(value == strs[i].size() * 3 && dic.value(str_id) == value);
+    assert(dic.lookup_value(strs[i], blob) == str_id);
+    assert(blob == strs[i].substr(0, i % 5) && dic.blob(str_id) == blob);
+  }
+
+  uint32_t value = 0;
+  assert(dic.lookup_value(strs[0] + "#", value) == cda_tries::NOT_FOUND);
+  assert(dic.value(static_cast<uint32_t>(strs.size())) == cda_tries::NOT_FOUND);
+
+  // Nothing is attached after rebuilding.
+  dic.build(strs, type);
+  std::string_view blob;
+  assert(dic.lookup_value(strs[0], value) == cda_tries::NOT_FOUND);
+  assert(dic.lookup_value(strs[0], blob) == cda_tries::NOT_FOUND);
+  assert(dic.value(0) == cda_tries::NOT_FOUND && dic.blob(0).empty());
+}
+
+void TestAccessCache(cda_tries::bc_type type, const std::vector<std::string> &strs) {
+  cda_tries::DaTrieDic dic;
+  dic.build(strs, type);
+
+  cda_tries::AccessCache cache(dic, 100, 128 * 64);
+  assert(cache.num_entries() == 128);
+  assert(cache.entry_bytes() == 64);
+
+  for (size_t run = 0; run < 2; ++run) {
+    for (uint32_t str_id = 0; str_id < strs.size(); str_id += 101) {
+      auto str = cache.access(str_id);
+      assert(str == dic.access(str_id));
+      assert(cache.access(str_id) == str);
+    }
+  }
+  assert(cache.num_hits() != 0);
+  assert(cache.num_misses() != 0);
+  assert(cache.access(cda_tries::NOT_FOUND).empty());
+
+  cache.clear();
+  assert(cache.num_hits() == 0 && cache.num_misses() == 0);
+
+  cda_tries::AccessCache empty_cache(dic, 4, 0);
+  assert(empty_cache.entry_bytes() == 0);
+  assert(empty_cache.access(0) == dic.access(0));
+  assert(empty_cache.num_hits() == 0 && empty_cache.num_misses() == 1);
+}
+
+void TestQueryExecutor(cda_tries::bc_type type, const std::vector<std::string> &strs) {
+  cda_tries::DaTrieDic dic;
+  dic.build(strs, type);
+
+  std::vector<std::string> queries(strs);
+  for (size_t i = 0; i < strs.size(); i += 3) {
+    queries.push_back(strs[i] + "#");
+  }
+  std::vector<std::string_view> views(queries.begin(), queries.end());
+
+  cda_tries::QueryExecutor executor(4);
+  assert(executor.num_threads() == 4);
+
+  for (size_t run = 0; run < 2; ++run) {
+    std::vector<uint32_t> ids(views.size());
+    executor.lookup_batch(dic, views.data(), views.size(), ids.data());
+    for (size_t i = 0; i < views.size(); ++i) {
+      assert(ids[i] == dic.lookup(views[i]));
+    }
+
+    std::vector<std::string> rets(strs.size());
+    executor.access_batch(dic, ids.data(), strs.size(), rets.data());
+    assert(rets == strs);
+
+    std::vector<cda_tries::match_t> matches(views.size());
+    executor.longest_prefix_match_batch(dic, views.data(), views.size(), matches.data());
+    for (size_t i = 0; i < views.size(); ++i) {
+      auto match = dic.longest_prefix_match(views[i]);
+      assert(matches[i].str_id == match.str_id && matches[i].length == match.length);
+    }
+  }
+
+  // Concurrent calls on one executor
+  std::vector<uint32_t> ids1(views.size()), ids2(views.size());
+  std::thread thread([&]() {
+    executor.lookup_batch(dic, views.data(), views.size(), ids1.data());
+  });
+  executor.lookup_batch(dic, views.data(), views.size(), ids2.data());
+  thread.join();
+  for (size_t i = 0; i < views.size(); ++i) {
+    assert(ids1[i] == dic.lookup(views[i]) && ids2[i] == ids1[i]);
+  }
+}
+
+template <class BcT>
+void TestBasicDaTrieDic(const std::vector<std::string> &strs) {
+  cda_tries::DaTrieDic dic;
+  dic.build(strs, BcT::TYPE);
+
+  cda_tries::BasicDaTrieDic<BcT> basic_dic;
+  basic_dic.build(strs);
+
+  assert(basic_dic.type() == dic.type());
+  assert(basic_dic.num_strs() == dic.num_strs());
+  assert(basic_dic.size_in_bytes() == dic.size_in_bytes());
+
+  std::stringstream ss;
+  basic_dic.write(ss);
+  basic_dic.read(ss);
+
+  for (size_t i = 0; i < strs.size(); ++i) {
+    auto str_id = basic_dic.lookup(strs[i].c_str());
+    assert(str_id == dic.lookup(strs[i].c_str()));
+    std::string ret;
+    basic_dic.access(str_id, ret);
+    assert(ret == strs[i]);
+  }
 }
 
 } // namespace
@@ -79,5 +1031,86 @@ int main() {
   TestDaTrieDic(cda_tries::bc_type::DAC, strs);
   TestDaTrieDic(cda_tries::bc_type::FDAC, strs);
 
+  TestCommonPrefixSearch(cda_tries::bc_type::PLAIN, strs);
+  TestCommonPrefixSearch(cda_tries::bc_type::DAC, strs);
+  TestCommonPrefixSearch(cda_tries::bc_type::FDAC, strs);
+
+  TestCountPrefix(cda_tries::bc_type::PLAIN, strs);
+  TestCountPrefix(cda_tries::bc_type::DAC, strs);
+  TestCountPrefix(cda_tries::bc_type::FDAC, strs);
+
+  TestRange(cda_tries::bc_type::PLAIN, strs);
+  TestRange(cda_tries::bc_type::DAC, strs);
+  TestRange(cda_tries::bc_type::FDAC, strs);
+
+  TestTopkCompletions(cda_tries::bc_type::PLAIN, strs);
+  TestTopkCompletions(cda_tries::bc_type::DAC, strs);
+  TestTopkCompletions(cda_tries::bc_type::FDAC, strs);
+
+  TestSetOperations(cda_tries::bc_type::PLAIN, strs);
+  TestSetOperations(cda_tries::bc_type::DAC, strs);
+  TestSetOperations(cda_tries::bc_type::FDAC, strs);
+
+  TestScan(cda_tries::bc_type::PLAIN, strs);
+  TestScan(cda_tries::bc_type::DAC, strs);
+  TestScan(cda_tries::bc_type::FDAC, strs);
+
+  TestCursor(cda_tries::bc_type::PLAIN, strs);
+  TestCursor(cda_tries::bc_type::DAC, strs);
+  TestCursor(cda_tries::bc_type::FDAC, strs);
+
+  TestEnumerator(cda_tries::bc_type::PLAIN, strs);
+  TestEnumerator(cda_tries::bc_type::DAC, strs);
+  TestEnumerator(cda_tries::bc_type::FDAC, strs);
+
+  TestFuzzySearch(cda_tries::bc_type::PLAIN, strs);
+  TestFuzzySearch(cda_tries::bc_type::DAC, strs);
+  TestFuzzySearch(cda_tries::bc_type::FDAC, strs);
+
+  TestPattern();
+  TestPatternSearch(cda_tries::bc_type::PLAIN, strs);
+  TestPatternSearch(cda_tries::bc_type::DAC, strs);
+  TestPatternSearch(cda_tries::bc_type::FDAC, strs);
+
+  TestDeepEnumerate(cda_tries::bc_type::PLAIN);
+  TestDeepEnumerate(cda_tries::bc_type::DAC);
+  TestDeepEnumerate(cda_tries::bc_type::FDAC);
+
+  TestSmallIO(cda_tries::bc_type::PLAIN);
+  TestSmallIO(cda_tries::bc_type::DAC);
+  TestSmallIO(cda_tries::bc_type::FDAC);
+
+  TestLongestPrefixMatch(cda_tries::bc_type::PLAIN, strs);
+  TestLongestPrefixMatch(cda_tries::bc_type::DAC, strs);
+  TestLongestPrefixMatch(cda_tries::bc_type::FDAC, strs);
+
+  TestPredictiveSearch(cda_tries::bc_type::PLAIN, strs);
+  TestPredictiveSearch(cda_tries::bc_type::DAC, strs);
+  TestPredictiveSearch(cda_tries::bc_type::FDAC, strs);
+
+  TestLexIds(cda_tries::bc_type::PLAIN, strs);
+  TestLexIds(cda_tries::bc_type::DAC, strs);
+  TestLexIds(cda_tries::bc_type::FDAC, strs);
+
+  TestCaseFolding(cda_tries::bc_type::PLAIN, strs);
+  TestCaseFolding(cda_tries::bc_type::DAC, strs);
+  TestCaseFolding(cda_tries::bc_type::FDAC, strs);
+
+  TestValues(cda_tries::bc_type::PLAIN, strs);
+  TestValues(cda_tries::bc_type::DAC, strs);
+  TestValues(cda_tries::bc_type::FDAC, strs);
+
+  TestAccessCache(cda_tries::bc_type::PLAIN, strs);
+  TestAccessCache(cda_tries::bc_type::DAC, strs);
+  TestAccessCache(cda_tries::bc_type::FDAC, strs);
+
+  TestQueryExecutor(cda_tries::bc_type::PLAIN, strs);
+  TestQueryExecutor(cda_tries::bc_type::DAC, strs);
+  TestQueryExecutor(cda_tries::bc_type::FDAC, strs);
+
+  TestBasicDaTrieDic<cda_tries::PlainBc>(strs);
+  TestBasicDaTrieDic<cda_tries::DacBc>(strs);
+  TestBasicDaTrieDic<cda_tries::FastDacBc>(strs);
+
   return 0;
 }
@@ -0,0 +1,56 @@
+#include "AccessCache.hpp"
+
+namespace cda_tries {
+
+AccessCache::AccessCache(const DaTrieDic &dic, size_t num_entries, size_t num_bytes)
+  : dic_(dic) {
+  size_t size = 2;
+  while (size < num_entries) {
+    size <<= 1;
+  }
+  ids_.reset(size, NOT_FOUND);
+  lengths_.reset(size, 0);
+  entry_bytes_ = num_bytes / size;
+  bytes_.reset(entry_bytes_ * size);
+  mask_ = static_cast<uint32_t>(size - 1);
+}
+
+AccessCache::~AccessCache() {}
+
+std::string_view AccessCache::access(uint32_t str_id) {
+  if (dic_.num_strs() <= str_id) {
+    return std::string_view();
+  }
+  // bytes_ is empty, so nothing is cached.
+  if (entry_bytes_ == 0) {
+    ++num_misses_;
+    return dic_.access(str_id);
+  }
+
+  auto pos = entry_pos_(str_id);
+  auto buf = &bytes_[0] + pos * entry_bytes_;
+  if (ids_[pos] == str_id) {
+    ++num_hits_;
+    return std::string_view(buf, lengths_[pos]);
+  }
+
+  ++num_misses_;
+  auto length = dic_.access(str_id, buf, entry_bytes_);
+  if (entry_bytes_ < length) {
+    ids_[pos] = NOT_FOUND; // buf may be overwritten
+    return dic_.access(str_id);
+  }
+  ids_[pos] = str_id;
+  lengths_[pos] = static_cast<uint32_t>(length);
+  return std::string_view(buf, length);
+}
+
+void AccessCache::clear() {
+  for (size_t i = 0; i < ids_.size(); ++i) {
+    ids_[i] = NOT_FOUND;
+  }
+  num_hits_   = 0;
+  num_misses_ = 0;
+}
+
+} // cda_tries
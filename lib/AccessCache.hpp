@@ -0,0 +1,52 @@
+#ifndef CDA_TRIES_ACCESS_CACHE_HPP
+#define CDA_TRIES_ACCESS_CACHE_HPP
+
+#include "DaTrieDic.hpp"
+
+namespace cda_tries {
+
+// Direct-mapped cache of the strings decoded by DaTrieDic::access. It is
+// meant to be owned by each thread, so that no synchronization is needed.
+// The byte budget is split evenly among the entries, and a string longer
+// than its share, or any string if the share is 0, is decoded every time
+// without being cached.
+class AccessCache {
+public:
+  // num_entries is rounded up to a power of two (at least 2).
+  AccessCache(const DaTrieDic &dic, size_t num_entries, size_t num_bytes);
+  ~AccessCache();
+
+  // Returns the string with str_id in [0,num_strs), which is valid until
+  // the next call.
+  std::string_view access(uint32_t str_id);
+
+  size_t num_entries() const { return ids_.size(); }
+  size_t entry_bytes() const { return entry_bytes_; }
+  size_t num_hits() const { return num_hits_; }
+  size_t num_misses() const { return num_misses_; }
+
+  // Drops the cached strings and resets the counters.
+  void clear();
+
+  AccessCache(const AccessCache &) = delete;
+  AccessCache &operator=(const AccessCache &) = delete;
+
+private:
+  const DaTrieDic &dic_;
+  Array<uint32_t> ids_;     // NOT_FOUND if the entry is empty
+  Array<uint32_t> lengths_;
+  Array<char> bytes_;
+  size_t entry_bytes_ = 0;
+  uint32_t mask_ = 0;
+  size_t num_hits_   = 0;
+  size_t num_misses_ = 0;
+
+  uint32_t entry_pos_(uint32_t str_id) const {
+    auto hash = str_id * 0x9E3779B9U;
+    return (hash ^ (hash >> 16)) & mask_;
+  }
+};
+
+} // cda_tries
+
+#endif // CDA_TRIES_ACCESS_CACHE_HPP
@@ -11,6 +11,7 @@
 #include <fstream>
 #include <memory>
 #include <string>
+#include <string_view>
 #include <vector>
 
 namespace cda_tries {
@@ -29,6 +30,12 @@ enum class bc_type {
   FDAC
 };
 
+// Order of the IDs assigned to the stored strings.
+enum class id_order : uint8_t {
+  PLACEMENT, // rank of the terminal node in the double array
+  LEX        // rank of the string in lexicographical order
+};
+
 class bc_t {
 public:
   bc_t() : base_(0), leaf_flag_(0), check_(0), fixed_flag_(0) {}
@@ -53,6 +60,26 @@ private:
   uint32_t fixed_flag_ : 1;
 };
 
+// Key of str_id matched with the first length bytes of a text.
+struct match_t {
+  uint32_t str_id;
+  size_t length;
+};
+
+// Position of a Cursor, which is at the internal node of node_pos if tail_pos
+// is NOT_FOUND, or at tail_pos in the tail of the leaf of node_pos otherwise.
+// node_pos is NOT_FOUND if no key starts with the bytes fed.
+struct cursor_t {
+  uint32_t node_pos = NOT_FOUND;
+  uint32_t tail_pos = NOT_FOUND;
+};
+
+// Key of str_id with its weight.
+struct weighted_t {
+  uint32_t str_id;
+  uint32_t weight;
+};
+
 enum class sw_type {
   SEC,
   MILLI,
@@ -115,6 +142,14 @@ inline void LoadStrings(std::istream &is, std::vector<std::string> &strs) {
   strs.shrink_to_fit();
 }
 
+inline void Prefetch(const void *ptr) {
+#if defined(__GNUC__)
+  __builtin_prefetch(ptr);
+#else
+  static_cast<void>(ptr);
+#endif
+}
+
 inline uint32_t PopCount(uint32_t bits) {
   bits = ((bits & 0xAAAAAAAA) >> 1) + (bits & 0x55555555);
   bits = ((bits & 0xCCCCCCCC) >> 2) + (bits & 0x33333333);
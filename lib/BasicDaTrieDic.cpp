@@ -0,0 +1,9 @@
+#include "BasicDaTrieDic.hpp"
+
+namespace cda_tries {
+
+template class BasicDaTrieDic<PlainBc>;
+template class BasicDaTrieDic<DacBc>;
+template class BasicDaTrieDic<FastDacBc>;
+
+} // cda_tries
@@ -0,0 +1,2261 @@
+#ifndef CDA_TRIES_BASIC_DA_TRIE_DIC_HPP
+#define CDA_TRIES_BASIC_DA_TRIE_DIC_HPP
+
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <iostream>
+
+#include "BitArray.hpp"
+#include "Builder.hpp"
+#include "CodeTable.hpp"
+#include "DacBc.hpp"
+#include "FastDacBc.hpp"
+#include "Pattern.hpp"
+#include "PlainBc.hpp"
+#include "SmallArray.hpp"
+#include "TrieDic.hpp"
+
+namespace cda_tries {
+
+// Dictionary over a concrete representation of BASE and CHECK. BcT is held
+// by value, so that its accessors are inlined into the query loops.
+template <class BcT>
+class BasicDaTrieDic final : public TrieDic {
+public:
+  static constexpr size_t BATCH_SIZE = 16;
+  // Head of a written dictionary, so that read rejects a file in another
+  // format, of another version, or of another bc_type.
+  static constexpr uint32_t MAGIC   = 0x54414443; // "CDAT"
+  static constexpr uint32_t VERSION = 1;
+
+  BasicDaTrieDic() {}
+  ~BasicDaTrieDic() {}
+
+  // Builds a dictinoary from sorted strs in lexicographical order. If order
+  // is id_order::LEX, the ID of strs[i] is i, so that the keys starting with
+  // a prefix have consecutive IDs.
+  //
+  // If fold_map is not the identity, the keys are stored with their labels
+  // folded, where the keys that become equal are merged, and IDs follow the
+  // folded keys. Queries are then matched through fold_map without being
+  // rewritten, and the strings are returned in the folded form.
+  void build(const std::vector<std::string> &strs, id_order order = id_order::PLACEMENT,
+             const fold_map_t &fold_map = IdentityFoldMap());
+
+  // Retruns the ID if str is in the dictionary, otherwise NOT_FOUND.
+  uint32_t lookup(const char *str) const;
+  // Same as lookup for str[0,length), which needs no terminator.
+  uint32_t lookup(const char *str, size_t length) const;
+  uint32_t lookup(std::string_view str) const {
+    return lookup(str.data(), str.size());
+  }
+  // Looks up strs[0,size) into ids[0,size). On PLAIN, up to BATCH_SIZE
+  // queries are advanced in lockstep, so that their cache misses overlap.
+  // On DAC and FDAC, the queries are looked up one by one, since a
+  // transition decodes the upper levels only after the first one is loaded
+  // and the lockstep costs more than it hides.
+  void lookup_batch(const char *const *strs, size_t size, uint32_t *ids) const;
+  void lookup_batch(const std::string_view *strs, size_t size, uint32_t *ids) const;
+  // Looks up strs[0,size) into ids[0,size), resuming each descent from the
+  // node of the longest common prefix with the previous string, so that the
+  // elements on the shared path are not decoded again. Any order is
+  // correct, but sorted strs share the most.
+  void lookup_sorted_batch(const char *const *strs, size_t size, uint32_t *ids) const;
+  void lookup_sorted_batch(const std::string_view *strs, size_t size, uint32_t *ids) const;
+  // Calls f(match_t) for each key that is a prefix of text[0,length),
+  // in increasing order of length.
+  template <class Func>
+  void common_prefix_search(const char *text, size_t length, Func f) const;
+  void common_prefix_search(const char *text, size_t length, std::vector<match_t> &ret) const;
+  void common_prefix_search(std::string_view text, std::vector<match_t> &ret) const {
+    common_prefix_search(text.data(), text.size(), ret);
+  }
+  // Calls f(str_id, str) for each key str starting with prefix, in
+  // lexicographical order, until f returns false or limit keys are reported.
+  // Returns the number of the reported keys.
+  template <class Func>
+  size_t predictive_search(std::string_view prefix, Func f, size_t limit = SIZE_MAX) const;
+  size_t predictive_search(std::string_view prefix,
+                           const std::function<bool(uint32_t, const std::string &)> &f,
+                           size_t limit) const;
+  // Calls f(str_id, str, distance) for each key str within Levenshtein
+  // distance max_distance of query, in lexicographical order, until f returns
+  // false or limit keys are reported. Returns the number of the reported keys.
+  template <class Func>
+  size_t fuzzy_search(std::string_view query, size_t max_distance, Func f,
+                      size_t limit = SIZE_MAX) const;
+  size_t fuzzy_search(std::string_view query, size_t max_distance,
+                      const std::function<bool(uint32_t, const std::string &, size_t)> &f,
+                      size_t limit) const;
+  // Calls f(str_id, str) for each key str matched by pattern, in
+  // lexicographical order, until f returns false or limit keys are reported.
+  // Returns the number of the reported keys.
+  template <class Func>
+  size_t pattern_search(const Pattern &pattern, Func f, size_t limit = SIZE_MAX) const;
+  size_t pattern_search(const Pattern &pattern,
+                        const std::function<bool(uint32_t, const std::string &)> &f,
+                        size_t limit) const;
+  // Returns the ID of the smallest key not less than key, or NOT_FOUND.
+  uint32_t lower_bound(std::string_view key) const;
+  // Returns the ID of the smallest key greater than key, or NOT_FOUND.
+  uint32_t upper_bound(std::string_view key) const;
+  // Calls f(str_id, str) for each key str in [lo,hi) in lexicographical
+  // order, until f returns false or limit keys are reported. Returns the
+  // number of the reported keys.
+  template <class Func>
+  size_t range(std::string_view lo, std::string_view hi, Func f,
+               size_t limit = SIZE_MAX) const;
+  size_t range(std::string_view lo, std::string_view hi,
+               const std::function<bool(uint32_t, const std::string &)> &f,
+               size_t limit) const;
+  // Returns the number of the keys starting with prefix. It takes
+  // O(|prefix|) time after build_count_index, otherwise it traverses the
+  // subtree of prefix.
+  size_t count_prefix(std::string_view prefix) const;
+  // Stores the number of the keys in the subtree of each internal node, in
+  // the bits of num_strs per node.
+  void build_count_index();
+  // Stores the labels of the first child and the next sibling of each node,
+  // in two bytes per element, so that traversals visit only the children
+  // instead of probing every label in use.
+  void build_child_index();
+  // Attaches weights[str_id] to the string with str_id, where weights.size()
+  // is num_strs, and stores the maximum weight in the subtree of each
+  // internal node for topk_completions.
+  void build_weights(const std::vector<uint32_t> &weights);
+  // Returns up to k keys starting with prefix in decreasing order of weight,
+  // visiting O(k*depth) nodes by best-first search. Returns nothing unless
+  // build_weights has been called.
+  void topk_completions(std::string_view prefix, size_t k, std::vector<weighted_t> &ret) const;
+  // Returns the longest key that is a prefix of str[0,length), or
+  // match_t{NOT_FOUND, 0} if no key is.
+  match_t longest_prefix_match(const char *str, size_t length) const;
+  match_t longest_prefix_match(std::string_view str) const {
+    return longest_prefix_match(str.data(), str.size());
+  }
+  // Runs longest_prefix_match for strs[i][0,lengths[i]) into ret[i] for
+  // i in [0,size), advancing the queries in lockstep as lookup_batch.
+  void longest_prefix_match_batch(const char *const *strs, const size_t *lengths,
+                                  size_t size, match_t *ret) const;
+  // Returns the string with str_id in [0,num_strs).
+  void access(uint32_t str_id, std::string &ret) const;
+  // Writes the string with str_id into buf without the terminator, and
+  // returns its length. If the length exceeds capacity, buf does not hold
+  // the string and may be partially overwritten.
+  size_t access(uint32_t str_id, char *buf, size_t capacity) const;
+  // Returns the string with str_id in a thread-local buffer, which is valid
+  // until the next call on the same thread.
+  std::string_view access(uint32_t str_id) const;
+  // Writes the strings with str_ids[0,size) into bytes, where the i-th one
+  // is bytes[offsets[i],offsets[i+1]), and is empty for an invalid ID. The
+  // path shared with the previous string is copied instead of decoded, so
+  // IDs in key order, e.g., sorted IDs in id_order::LEX, share the most.
+  void access_batch(const uint32_t *str_ids, size_t size, std::string &bytes,
+                    std::vector<size_t> &offsets) const;
+  // Returns all stored strings in lexicographical order.
+  void enumerate(std::vector<uint32_t> &ret) const;
+  // Calls f(str_id, str) for all stored strings in lexicographical order,
+  // until f returns false. Returns the number of the reported strings.
+  template <class Func>
+  size_t enumerate(Func f) const;
+  size_t enumerate(const std::function<bool(uint32_t, const std::string &)> &f) const;
+  // Calls f(str_id, str) for up to size keys in lexicographical order from
+  // the node of node_pos, which is 0 at first and is updated to the next
+  // node to visit, or NOT_FOUND at the end. f returning false stops after
+  // its key. The path of a node is recovered by climbing, so node_pos is
+  // the whole state of the enumeration.
+  template <class Func>
+  size_t enumerate(uint32_t &node_pos, size_t size, Func f) const;
+  size_t enumerate(uint32_t &node_pos, size_t size,
+                   const std::function<bool(uint32_t, const std::string &)> &f) const;
+
+  // Builds failure and output links for scan over the nodes and the bytes in
+  // the tails, each of which is a state of the Aho-Corasick automaton.
+  void build_scanner();
+  // Calls f(match_t{str_id, end}) for each occurrence of a key ending at
+  // text[end-1]. It takes linear time in length and the occurrences after
+  // build_scanner, reporting in increasing order of end, otherwise it runs
+  // common_prefix_search at every offset. The empty key ends at every offset
+  // in [0,length].
+  template <class Func>
+  void scan(const char *text, size_t length, Func f) const;
+  void scan(std::string_view text, const std::function<void(const match_t &)> &f) const;
+
+  // Returns the cursor at the root.
+  cursor_t cursor_root() const;
+  // Moves cursor by c, and returns false if no key starts with the bytes fed,
+  // after which cursor stays invalid.
+  bool cursor_feed(cursor_t &cursor, char c) const {
+    if (cursor.node_pos == NOT_FOUND) {
+      return false;
+    }
+    auto position = child_(position_t{cursor.node_pos, cursor.tail_pos == NOT_FOUND
+                                                         ? nullptr : &tail_[cursor.tail_pos]},
+                           static_cast<uint8_t>(table_.fold(c)));
+    cursor.node_pos = position.node_pos;
+    cursor.tail_pos = (position.tail == nullptr) ? NOT_FOUND
+                                                 : static_cast<uint32_t>(position.tail - &tail_[0]);
+    return cursor.node_pos != NOT_FOUND;
+  }
+  // Returns the ID of the key of the bytes fed to cursor, or NOT_FOUND.
+  uint32_t cursor_id(const cursor_t &cursor) const;
+  // Calls f(str_id, str) for each key starting with the bytes fed to cursor
+  // as predictive_search.
+  template <class Func>
+  size_t cursor_predict(const cursor_t &cursor, Func f, size_t limit = SIZE_MAX) const;
+  size_t cursor_predict(const cursor_t &cursor,
+                        const std::function<bool(uint32_t, const std::string &)> &f,
+                        size_t limit = SIZE_MAX) const;
+
+  // Calls f(str_id, other_id) for each key in both this and other, in
+  // lexicographical order. The tries are traversed in parallel, descending
+  // only into the labels on both sides.
+  void intersect(const TrieDic &other, const std::function<void(uint32_t, uint32_t)> &f) const;
+  // Calls f(str_id) for each key in this but not in other, in
+  // lexicographical order.
+  void difference(const TrieDic &other, const std::function<void(uint32_t)> &f) const;
+  // Calls f(str_id, other_id) for each key in this or other, in
+  // lexicographical order, where the ID on the side without the key is
+  // NOT_FOUND.
+  void merge(const TrieDic &other, const std::function<void(uint32_t, uint32_t)> &f) const;
+
+  bc_type type() const { return BcT::TYPE; }
+  id_order order() const { return order_; }
+  size_t num_strs() const { return num_strs_; }
+  size_t max_length() const { return max_length_; }
+
+  size_t bc_size() const { return bc_.size(); }
+  size_t tail_size() const { return tail_.size(); }
+  size_t size_in_bytes() const;
+
+  void stat(std::ostream &os) const;
+
+  void write(std::ostream &os) const;
+  void read(std::istream &is);
+
+  void clear();
+
+  BasicDaTrieDic(const BasicDaTrieDic &) = delete;
+  BasicDaTrieDic &operator=(const BasicDaTrieDic &) = delete;
+
+private:
+  template <class OtherBcT>
+  friend class BasicDaTrieDic;
+
+  BcT bc_;
+  BitArray term_flags_;
+  Array<char> tail_;
+  CodeTable table_;
+  // Label of the edge incoming to each node, which is empty unless the
+  // library is built with ENABLE_EDGE_LABELS.
+  Array<uint8_t> labels_;
+  SmallArray lex_ids_;  // lexicographical ID of each terminal node in rank order
+  SmallArray node_ids_; // terminal node of each lexicographical ID
+  BitArray internal_flags_; // internal nodes, if an index of them is built
+  // Label 0 stands for none, since no key contains it.
+  Array<uint8_t> child_labels_;   // label of the first child of each node
+  Array<uint8_t> sibling_labels_; // label of the next sibling of each node
+  SmallArray counts_;       // number of the keys under each internal node in rank order
+  SmallArray weights_;      // weight of each ID
+  SmallArray max_weights_;  // maximum weight under each internal node in rank order
+  // The states of the scanner are the nodes in [0,bc_size) and the bytes in
+  // the tails from bc_size, where those of a leaf are consecutive.
+  SmallArray ac_fails_;       // failure link of each state
+  SmallArray ac_outputs_;     // nearest terminal state on the failure chain, or 0
+  SmallArray ac_tail_states_; // first state in the tail of each leaf, or 0
+  BitArray ac_tail_ends_;     // whether each state from bc_size ends its tail
+  SmallArray ac_tail_leaves_; // leaf of each tail in the order of the states
+
+  id_order order_    = id_order::PLACEMENT;
+  size_t num_strs_   = 0;
+  size_t max_length_ = 0;
+
+  struct query_t {
+    const char *str   = nullptr;
+    const char *begin = nullptr;
+    const char *end   = nullptr;
+    const char *tail  = nullptr;
+    uint32_t node_pos  = 0;
+    uint32_t child_pos = 0;
+    uint32_t term_pos  = NOT_FOUND;
+    size_t id_pos = 0;
+    size_t length = 0;
+  };
+
+  uint32_t to_str_id_(uint32_t node_pos) const {
+    auto rank = term_flags_.rank(node_pos);
+    return (order_ == id_order::LEX) ? lex_ids_[rank] : rank;
+  };
+  uint32_t to_node_pos_(uint32_t str_id) const {
+    return (order_ == id_order::LEX) ? node_ids_[str_id] : term_flags_.select(str_id);
+  };
+
+  struct frame_t {
+    uint32_t node_pos;
+    uint32_t depth;
+    uint8_t  label;
+  };
+
+  template <class Init, class Step>
+  void run_batch_(size_t size, Init init, Step step) const;
+  size_t write_path_(uint32_t node_pos, char *end, size_t capacity) const;
+  bool lookup_step_(query_t &query, uint32_t &id) const;
+  bool longest_prefix_match_step_(query_t &query, match_t &ret) const;
+  void push_children_(const frame_t &frame, std::vector<frame_t> &stack) const;
+  template <class Func>
+  void traverse_(uint32_t node_pos, Func f) const;
+  template <class Func>
+  void traverse_(std::vector<frame_t> &stack, Func f) const;
+  template <class Func>
+  void scan_(std::string_view key, bool inclusive, Func f) const;
+  template <class Func>
+  size_t predict_(uint32_t node_pos, std::string &str, Func f, size_t limit) const;
+  uint32_t next_node_(uint32_t node_pos, std::string &str) const;
+  template <class Get>
+  void lookup_sorted_(size_t size, Get get, uint32_t *ids) const;
+  bool is_node_(uint32_t node_pos) const;
+  template <class Merge>
+  void build_node_index_(std::vector<uint32_t> &node_values, Merge merge, SmallArray &ret);
+
+  // Position in the trie, which is a node or a byte in the tail of a leaf.
+  // node_pos is NOT_FOUND if the position does not exist.
+  struct position_t {
+    uint32_t node_pos = NOT_FOUND;
+    const char *tail  = nullptr;
+  };
+
+  position_t root_() const;
+  position_t child_(const position_t &position, uint8_t label) const;
+  position_t descend_(std::string_view prefix) const;
+  bool is_terminal_(const position_t &position) const;
+  // Child of a position with the label of its incoming edge.
+  struct edge_t {
+    uint8_t label;
+    position_t child;
+  };
+  void children_(const position_t &position, std::vector<frame_t> &frames,
+                 std::vector<edge_t> &ret) const;
+  template <class Func>
+  void for_each_id_(const position_t &position, Func f) const;
+  template <class Func>
+  void merge_(const TrieDic &other, bool lhs_only, bool rhs_only, Func f) const;
+  template <class OtherBcT, class Func>
+  void merge_(const BasicDaTrieDic<OtherBcT> &other, bool lhs_only, bool rhs_only,
+              Func f) const;
+
+  const char *ac_tail_(uint32_t state, uint32_t &leaf_pos) const;
+  uint32_t ac_goto_(uint32_t state, uint8_t label) const;
+  bool ac_is_terminal_(uint32_t state) const;
+  uint32_t ac_str_id_(uint32_t state) const;
+};
+
+template <class BcT>
+void BasicDaTrieDic<BcT>::build(const std::vector<std::string> &strs, id_order order,
+                                const fold_map_t &fold_map) {
+  clear();
+  if (strs.empty()) {
+    return;
+  }
+
+  std::vector<std::string> folded_strs;
+  if (fold_map != IdentityFoldMap()) {
+    folded_strs = strs;
+    for (auto &str : folded_strs) {
+      for (auto &c : str) {
+        c = static_cast<char>(fold_map[static_cast<uint8_t>(c)]);
+      }
+    }
+    std::sort(folded_strs.begin(), folded_strs.end());
+    folded_strs.erase(std::unique(folded_strs.begin(), folded_strs.end()), folded_strs.end());
+  }
+  auto &keys = folded_strs.empty() ? strs : folded_strs;
+
+  num_strs_ = keys.size();
+  max_length_ = table_.build(keys, fold_map);
+
+  Builder builder(keys, table_);
+  builder.build_(BcT::TYPE);
+
+  bc_.build(builder.bc_);
+  term_flags_.build(builder.term_flags_);
+  tail_.build(builder.tail_);
+
+#ifdef ENABLE_EDGE_LABELS
+  auto &bc = builder.bc_;
+  labels_.reset(bc.size(), 0);
+  for (uint32_t pos = 1; pos < bc.size(); ++pos) {
+    if (bc[pos].is_fixed()) {
+      auto code = static_cast<uint8_t>(bc[bc[pos].check()].base() ^ pos);
+      labels_[pos] = table_.label(code);
+    }
+  }
+#endif
+
+  if (order == id_order::LEX) {
+    // The ranks are enumerated in lexicographical order before order_ is set.
+    std::vector<uint32_t> ranks;
+    enumerate(ranks);
+    std::vector<uint32_t> lex_ids(ranks.size()), node_ids(ranks.size());
+    for (uint32_t i = 0; i < ranks.size(); ++i) {
+      lex_ids[ranks[i]] = i;
+      node_ids[i] = term_flags_.select(ranks[i]);
+    }
+    lex_ids_.build(lex_ids);
+    node_ids_.build(node_ids);
+    order_ = order;
+  }
+}
+
+template <class BcT>
+uint32_t BasicDaTrieDic<BcT>::lookup(const char *str) const {
+  if (num_strs_ == 0) {
+    return NOT_FOUND;
+  }
+  uint32_t node_pos = 0;
+
+  while (!bc_.is_leaf(node_pos)) {
+    if (*str == '\0') {
+      return term_flags_[node_pos] ? to_str_id_(node_pos) : NOT_FOUND;
+    }
+    auto label = static_cast<uint8_t>(*str++);
+    auto child_pos = bc_.base(node_pos) ^ table_.code(label);
+    if (child_pos == 0 || bc_.check(child_pos) != node_pos) {
+      return NOT_FOUND;
+    }
+    node_pos = child_pos;
+  }
+
+  auto tail = &tail_[bc_.link(node_pos)];
+  while (*tail != '\0' && *tail == table_.fold(*str)) {
+    ++tail;
+    ++str;
+  }
+  return (*tail == '\0' && *str == '\0') ? to_str_id_(node_pos) : NOT_FOUND;
+}
+
+template <class BcT>
+uint32_t BasicDaTrieDic<BcT>::lookup(const char *str, size_t length) const {
+  if (num_strs_ == 0) {
+    return NOT_FOUND;
+  }
+  auto end = str + length;
+  uint32_t node_pos = 0;
+
+  while (!bc_.is_leaf(node_pos)) {
+    if (str == end) {
+      return term_flags_[node_pos] ? to_str_id_(node_pos) : NOT_FOUND;
+    }
+    auto label = static_cast<uint8_t>(*str++);
+    auto child_pos = bc_.base(node_pos) ^ table_.code(label);
+    if (child_pos == 0 || bc_.check(child_pos) != node_pos) {
+      return NOT_FOUND;
+    }
+    node_pos = child_pos;
+  }
+
+  auto tail = &tail_[bc_.link(node_pos)];
+  for (; str != end; ++str, ++tail) {
+    if (*tail == '\0' || *tail != table_.fold(*str)) {
+      return NOT_FOUND;
+    }
+  }
+  return (*tail == '\0') ? to_str_id_(node_pos) : NOT_FOUND;
+}
+
+template <class BcT>
+void BasicDaTrieDic<BcT>::lookup_batch(const char *const *strs, size_t size,
+                                       uint32_t *ids) const {
+  if (num_strs_ == 0) {
+    std::fill(ids, ids + size, NOT_FOUND);
+    return;
+  }
+  if (BcT::TYPE != bc_type::PLAIN) {
+    for (size_t i = 0; i < size; ++i) {
+      ids[i] = lookup(strs[i]);
+    }
+    return;
+  }
+  run_batch_(size, [&](query_t &query) {
+    query.str = strs[query.id_pos];
+    query.end = query.str + std::strlen(query.str);
+  }, [&](query_t &query) {
+    return lookup_step_(query, ids[query.id_pos]);
+  });
+}
+
+template <class BcT>
+void BasicDaTrieDic<BcT>::lookup_batch(const std::string_view *strs, size_t size,
+                                       uint32_t *ids) const {
+  if (num_strs_ == 0) {
+    std::fill(ids, ids + size, NOT_FOUND);
+    return;
+  }
+  if (BcT::TYPE != bc_type::PLAIN) {
+    for (size_t i = 0; i < size; ++i) {
+      ids[i] = lookup(strs[i]);
+    }
+    return;
+  }
+  run_batch_(size, [&](query_t &query) {
+    query.str = strs[query.id_pos].data();
+    query.end = query.str + strs[query.id_pos].size();
+  }, [&](query_t &query) {
+    return lookup_step_(query, ids[query.id_pos]);
+  });
+}
+
+template <class BcT>
+void BasicDaTrieDic<BcT>::lookup_sorted_batch(const char *const *strs, size_t size,
+                                              uint32_t *ids) const {
+  lookup_sorted_(size, [&](size_t i) {
+    return std::string_view(strs[i]);
+  }, ids);
+}
+
+template <class BcT>
+void BasicDaTrieDic<BcT>::lookup_sorted_batch(const std::string_view *strs, size_t size,
+                                              uint32_t *ids) const {
+  lookup_sorted_(size, [&](size_t i) {
+    return strs[i];
+  }, ids);
+}
+
+template <class BcT>
+template <class Func>
+void BasicDaTrieDic<BcT>::common_prefix_search(const char *text, size_t length,
+                                               Func f) const {
+  if (num_strs_ == 0) {
+    return;
+  }
+
+  uint32_t node_pos = 0;
+  size_t pos = 0;
+
+  while (!bc_.is_leaf(node_pos)) {
+    if (term_flags_[node_pos]) {
+      f(match_t{to_str_id_(node_pos), pos});
+    }
+    if (pos == length) {
+      return;
+    }
+    auto label = static_cast<uint8_t>(text[pos]);
+    auto child_pos = bc_.base(node_pos) ^ table_.code(label);
+    if (child_pos == 0 || bc_.check(child_pos) != node_pos) {
+      return;
+    }
+    node_pos = child_pos;
+    ++pos;
+  }
+
+  auto tail = &tail_[bc_.link(node_pos)];
+  while (*tail != '\0' && pos < length && *tail == table_.fold(text[pos])) {
+    ++tail;
+    ++pos;
+  }
+  if (*tail == '\0') {
+    f(match_t{to_str_id_(node_pos), pos});
+  }
+}
+
+template <class BcT>
+void BasicDaTrieDic<BcT>::common_prefix_search(const char *text, size_t length,
+                                               std::vector<match_t> &ret) const {
+  ret.clear();
+  common_prefix_search(text, length, [&](const match_t &match) {
+    ret.push_back(match);
+  });
+}
+
+template <class BcT>
+template <class Func>
+size_t BasicDaTrieDic<BcT>::predictive_search(std::string_view prefix, Func f,
+                                              size_t limit) const {
+  if (num_strs_ == 0 || limit == 0) {
+    return 0;
+  }
+
+  // Reported strings start with prefix in the folded form.
+  std::string str;
+  str.reserve(max_length_);
+  for (auto c : prefix) {
+    str += table_.fold(c);
+  }
+  auto position = descend_(prefix);
+  if (position.node_pos == NOT_FOUND) {
+    return 0;
+  }
+  if (position.tail != nullptr) {
+    str += position.tail;
+    f(to_str_id_(position.node_pos), static_cast<const std::string &>(str));
+    return 1;
+  }
+  return predict_(position.node_pos, str, f, limit);
+}
+
+template <class BcT>
+size_t BasicDaTrieDic<BcT>::predictive_search(
+  std::string_view prefix, const std::function<bool(uint32_t, const std::string &)> &f,
+  size_t limit) const {
+  return predictive_search<decltype(f)>(prefix, f, limit);
+}
+
+// The keys are visited in depth-first order with a row of the edit distance
+// matrix per depth, where cell(depth,j) is the distance between the first
+// depth bytes of the key and query[0,j). Only the cells within the band
+// |depth-j| <= max_distance are computed and stored, together with the one
+// on each side capped at max_distance+1, and a subtree is pruned when its
+// row has no cell within max_distance. The tail of a leaf extends the rows
+// in the same way.
+template <class BcT>
+template <class Func>
+size_t BasicDaTrieDic<BcT>::fuzzy_search(std::string_view query, size_t max_distance,
+                                         Func f, size_t limit) const {
+  if (num_strs_ == 0 || limit == 0) {
+    return 0;
+  }
+
+  std::string folded_query;
+  for (auto c : query) {
+    folded_query += table_.fold(c);
+  }
+  query = folded_query;
+  // No distance exceeds the longer length, and cap must not overflow.
+  max_distance = std::min(max_distance, std::max(query.size(), max_length_));
+
+  // A row holds j in [depth-max_distance-1, depth+max_distance+1], so that
+  // cell(depth,j) of the previous row is one to the right in its row.
+  auto width = 2 * max_distance + 3;
+  auto cap = max_distance + 1;
+  std::vector<size_t> rows((max_length_ + 1) * width);
+  auto cell = [&](size_t depth, size_t j) -> size_t & {
+    return rows[depth * width + j + max_distance + 1 - depth];
+  };
+  for (size_t j = 0; j <= cap; ++j) {
+    cell(0, j) = j;
+  }
+
+  // Computes the row of depth from that of depth-1 extended by label, and
+  // returns whether it has a cell within max_distance. Only the band [lo,hi]
+  // is computed, and the cells just outside it are capped since the band of
+  // the row and that of the next one read them.
+  auto extend = [&](size_t depth, char label) {
+    auto lo = (depth > max_distance) ? depth - max_distance : 1;
+    auto hi = std::min(query.size(), depth + max_distance);
+    auto cur = &cell(depth, lo);
+    auto prev = &cell(depth - 1, lo) - 1; // prev[i] is next to cur[i] diagonally
+    auto left = (lo == 1) ? std::min(depth, cap) : cap; // cell(depth,lo-1)
+    cur[-1] = left;
+    cur[hi + 1 - lo] = cap;
+    bool alive = left <= max_distance;
+    for (size_t i = 0; lo + i <= hi; ++i) {
+      auto cost = std::min(prev[i + 1], left) + 1;
+      cost = std::min(cost, prev[i] + (query[lo + i - 1] != label));
+      left = cur[i] = std::min(cost, cap);
+      alive |= left <= max_distance;
+    }
+    return alive;
+  };
+
+  std::string str;
+  str.reserve(max_length_);
+  std::vector<frame_t> stack;
+  stack.reserve(max_length_ + table_.alphabet_size());
+  stack.push_back(frame_t{0, 0, 0});
+  size_t count = 0;
+
+  auto report = [&](uint32_t node_pos, size_t depth) {
+    // The last cell is out of the band.
+    if (depth + max_distance < query.size()) {
+      return true;
+    }
+    auto distance = cell(depth, query.size());
+    if (max_distance < distance) {
+      return true;
+    }
+    ++count;
+    return f(to_str_id_(node_pos), static_cast<const std::string &>(str), distance)
+           && count != limit;
+  };
+
+  while (!stack.empty()) {
+    auto frame = stack.back();
+    stack.pop_back();
+
+    str.resize(frame.depth);
+    if (frame.depth != 0) {
+      str.back() = static_cast<char>(frame.label);
+      if (!extend(frame.depth, str.back())) {
+        continue;
+      }
+    }
+
+    if (bc_.is_leaf(frame.node_pos)) {
+      size_t depth = frame.depth;
+      bool alive = true;
+      for (auto tail = &tail_[bc_.link(frame.node_pos)]; alive && *tail != '\0'; ++tail) {
+        str += *tail;
+        alive = extend(++depth, *tail);
+      }
+      if (alive && !report(frame.node_pos, depth)) {
+        return count;
+      }
+      continue;
+    }
+
+    if (term_flags_[frame.node_pos] && !report(frame.node_pos, frame.depth)) {
+      return count;
+    }
+    push_children_(frame, stack);
+  }
+  return count;
+}
+
+template <class BcT>
+size_t BasicDaTrieDic<BcT>::fuzzy_search(
+  std::string_view query, size_t max_distance,
+  const std::function<bool(uint32_t, const std::string &, size_t)> &f, size_t limit) const {
+  return fuzzy_search<decltype(f)>(query, max_distance, f, limit);
+}
+
+// The DFA of pattern is run in lockstep with the depth-first traversal,
+// keeping its state per depth, and a subtree is pruned when the state is
+// DEAD. The tail of a leaf is fed to the DFA in the same way.
+template <class BcT>
+template <class Func>
+size_t BasicDaTrieDic<BcT>::pattern_search(const Pattern &pattern, Func f,
+                                           size_t limit) const {
+  if (num_strs_ == 0 || pattern.num_states() == 0 || limit == 0) {
+    return 0;
+  }
+
+  std::vector<uint32_t> states(max_length_ + 1);
+  states[0] = pattern.start();
+
+  std::string str;
+  str.reserve(max_length_);
+  std::vector<frame_t> stack;
+  stack.reserve(max_length_ + table_.alphabet_size());
+  stack.push_back(frame_t{0, 0, 0});
+  size_t count = 0;
+
+  auto report = [&](uint32_t node_pos) {
+    ++count;
+    return f(to_str_id_(node_pos), static_cast<const std::string &>(str)) && count != limit;
+  };
+
+  while (!stack.empty()) {
+    auto frame = stack.back();
+    stack.pop_back();
+
+    auto state = states[frame.depth];
+    str.resize(frame.depth);
+    if (frame.depth != 0) {
+      str.back() = static_cast<char>(frame.label);
+      state = states[frame.depth] = pattern.next(states[frame.depth - 1], frame.label);
+      if (state == Pattern::DEAD) {
+        continue;
+      }
+    }
+
+    if (bc_.is_leaf(frame.node_pos)) {
+      auto tail = &tail_[bc_.link(frame.node_pos)];
+      for (; state != Pattern::DEAD && *tail != '\0'; ++tail) {
+        state = pattern.next(state, static_cast<uint8_t>(*tail));
+      }
+      if (state != Pattern::DEAD && pattern.is_accepting(state)) {
+        str += &tail_[bc_.link(frame.node_pos)];
+        if (!report(frame.node_pos)) {
+          return count;
+        }
+      }
+      continue;
+    }
+
+    if (term_flags_[frame.node_pos] && pattern.is_accepting(state) && !report(frame.node_pos)) {
+      return count;
+    }
+    push_children_(frame, stack);
+  }
+  return count;
+}
+
+template <class BcT>
+size_t BasicDaTrieDic<BcT>::pattern_search(
+  const Pattern &pattern, const std::function<bool(uint32_t, const std::string &)> &f,
+  size_t limit) const {
+  return pattern_search<decltype(f)>(pattern, f, limit);
+}
+
+template <class BcT>
+uint32_t BasicDaTrieDic<BcT>::lower_bound(std::string_view key) const {
+  uint32_t ret = NOT_FOUND;
+  scan_(key, true, [&](uint32_t node_pos, const std::string &) {
+    ret = to_str_id_(node_pos);
+    return false;
+  });
+  return ret;
+}
+
+template <class BcT>
+uint32_t BasicDaTrieDic<BcT>::upper_bound(std::string_view key) const {
+  uint32_t ret = NOT_FOUND;
+  scan_(key, false, [&](uint32_t node_pos, const std::string &) {
+    ret = to_str_id_(node_pos);
+    return false;
+  });
+  return ret;
+}
+
+template <class BcT>
+template <class Func>
+size_t BasicDaTrieDic<BcT>::range(std::string_view lo, std::string_view hi, Func f,
+                                  size_t limit) const {
+  if (limit == 0) {
+    return 0;
+  }
+  std::string folded_hi;
+  for (auto c : hi) {
+    folded_hi += table_.fold(c);
+  }
+
+  size_t count = 0;
+  scan_(lo, true, [&](uint32_t node_pos, const std::string &str) {
+    if (folded_hi <= str) {
+      return false;
+    }
+    ++count;
+    return f(to_str_id_(node_pos), str) && count != limit;
+  });
+  return count;
+}
+
+template <class BcT>
+size_t BasicDaTrieDic<BcT>::range(
+  std::string_view lo, std::string_view hi,
+  const std::function<bool(uint32_t, const std::string &)> &f, size_t limit) const {
+  return range<decltype(f)>(lo, hi, f, limit);
+}
+
+template <class BcT>
+size_t BasicDaTrieDic<BcT>::count_prefix(std::string_view prefix) const {
+  if (num_strs_ == 0) {
+    return 0;
+  }
+
+  auto position = descend_(prefix);
+  if (position.node_pos == NOT_FOUND) {
+    return 0;
+  }
+  if (position.tail != nullptr) {
+    return 1;
+  }
+  auto node_pos = position.node_pos;
+  if (counts_.size() != 0) {
+    return counts_[internal_flags_.rank(node_pos)];
+  }
+
+  size_t count = 0;
+  traverse_(node_pos, [&](const frame_t &frame) {
+    count += term_flags_[frame.node_pos];
+    return true;
+  });
+  return count;
+}
+
+// The counts are accumulated from each node to its parent in the reverse of
+// the preorder, in which every node comes after all its descendants.
+template <class BcT>
+void BasicDaTrieDic<BcT>::build_count_index() {
+  counts_.clear();
+  if (num_strs_ == 0) {
+    return;
+  }
+
+  std::vector<uint32_t> node_counts(bc_.size(), 0);
+  for (uint32_t node_pos = 0; node_pos < bc_.size(); ++node_pos) {
+    node_counts[node_pos] = term_flags_[node_pos];
+  }
+  build_node_index_(node_counts, [](uint32_t lhs, uint32_t rhs) {
+    return lhs + rhs;
+  }, counts_);
+}
+
+// The children are listed by probing the labels before the index is set.
+template <class BcT>
+void BasicDaTrieDic<BcT>::build_child_index() {
+  child_labels_.clear();
+  sibling_labels_.clear();
+  if (num_strs_ == 0) {
+    return;
+  }
+
+  std::vector<uint8_t> child_labels(bc_.size(), 0), sibling_labels(bc_.size(), 0);
+  std::vector<frame_t> children;
+  traverse_(0, [&](const frame_t &frame) {
+    if (!bc_.is_leaf(frame.node_pos)) {
+      children.clear();
+      push_children_(frame, children);
+      child_labels[frame.node_pos] = children.back().label;
+      for (size_t i = children.size() - 1; i != 0; --i) {
+        sibling_labels[children[i].node_pos] = children[i - 1].label;
+      }
+    }
+    return true;
+  });
+  child_labels_.build(child_labels);
+  sibling_labels_.build(sibling_labels);
+}
+
+template <class BcT>
+void BasicDaTrieDic<BcT>::build_weights(const std::vector<uint32_t> &weights) {
+  if (weights.size() != num_strs_) {
+    std::cerr << "Critical error: the number of weights differs from num_strs" << std::endl;
+    exit(1);
+  }
+  weights_.clear();
+  max_weights_.clear();
+  if (num_strs_ == 0) {
+    return;
+  }
+
+  weights_.build(weights);
+  std::vector<uint32_t> node_weights(bc_.size(), 0);
+  for (uint32_t node_pos = 0; node_pos < bc_.size(); ++node_pos) {
+    if (term_flags_[node_pos]) {
+      node_weights[node_pos] = weights[to_str_id_(node_pos)];
+    }
+  }
+  build_node_index_(node_weights, [](uint32_t lhs, uint32_t rhs) {
+    return std::max(lhs, rhs);
+  }, max_weights_);
+}
+
+// Expands the best node in the queue, whose priority is the maximum weight in
+// its subtree, or reports it if it stands for a key. A key is queued before
+// being reported so that it is reported after the subtrees of larger weights.
+template <class BcT>
+void BasicDaTrieDic<BcT>::topk_completions(std::string_view prefix, size_t k,
+                                           std::vector<weighted_t> &ret) const {
+  ret.clear();
+  // max_weights_ is empty if the root is a leaf, even after build_weights.
+  if (num_strs_ == 0 || weights_.size() == 0 || k == 0) {
+    return;
+  }
+
+  auto position = descend_(prefix);
+  if (position.node_pos == NOT_FOUND) {
+    return;
+  }
+
+  struct entry_t {
+    uint32_t weight;
+    uint32_t node_pos;
+    bool is_key;
+    bool operator<(const entry_t &rhs) const {
+      return weight != rhs.weight ? weight < rhs.weight : is_key < rhs.is_key;
+    }
+  };
+  std::vector<entry_t> heap;
+  std::vector<frame_t> children;
+
+  auto push = [&](uint32_t node_pos) {
+    if (bc_.is_leaf(node_pos)) {
+      heap.push_back(entry_t{weights_[to_str_id_(node_pos)], node_pos, true});
+    } else {
+      heap.push_back(entry_t{max_weights_[internal_flags_.rank(node_pos)], node_pos, false});
+    }
+    std::push_heap(heap.begin(), heap.end());
+  };
+
+  push(position.node_pos);
+  while (!heap.empty() && ret.size() < k) {
+    std::pop_heap(heap.begin(), heap.end());
+    auto entry = heap.back();
+    heap.pop_back();
+
+    if (entry.is_key) {
+      ret.push_back(weighted_t{to_str_id_(entry.node_pos), entry.weight});
+      continue;
+    }
+    if (term_flags_[entry.node_pos]) {
+      heap.push_back(entry_t{weights_[to_str_id_(entry.node_pos)], entry.node_pos, true});
+      std::push_heap(heap.begin(), heap.end());
+    }
+    children.clear();
+    push_children_(frame_t{entry.node_pos, 0, 0}, children);
+    for (auto &child : children) {
+      push(child.node_pos);
+    }
+  }
+}
+
+template <class BcT>
+match_t BasicDaTrieDic<BcT>::longest_prefix_match(const char *str, size_t length) const {
+  match_t ret{NOT_FOUND, 0};
+  common_prefix_search(str, length, [&](const match_t &match) {
+    ret = match;
+  });
+  return ret;
+}
+
+template <class BcT>
+void BasicDaTrieDic<BcT>::longest_prefix_match_batch(const char *const *strs,
+                                                     const size_t *lengths, size_t size,
+                                                     match_t *ret) const {
+  if (num_strs_ == 0) {
+    std::fill(ret, ret + size, match_t{NOT_FOUND, 0});
+    return;
+  }
+  run_batch_(size, [&](query_t &query) {
+    query.str = query.begin = strs[query.id_pos];
+    query.end = query.str + lengths[query.id_pos];
+  }, [&](query_t &query) {
+    return longest_prefix_match_step_(query, ret[query.id_pos]);
+  });
+}
+
+template <class BcT>
+void BasicDaTrieDic<BcT>::access(uint32_t str_id, std::string &ret) const {
+  auto str = access(str_id);
+  ret.assign(str.data(), str.size());
+}
+
+template <class BcT>
+size_t BasicDaTrieDic<BcT>::access(uint32_t str_id, char *buf, size_t capacity) const {
+  if (num_strs_ <= str_id) {
+    return 0;
+  }
+
+  auto node_pos = to_node_pos_(str_id);
+  auto tail = &tail_[bc_.is_leaf(node_pos) ? bc_.link(node_pos) : 0];
+
+  auto depth = write_path_(node_pos, buf + capacity, capacity);
+  auto tail_length = std::strlen(tail);
+  if (capacity < depth + tail_length) {
+    return depth + tail_length;
+  }
+
+  std::memmove(buf, buf + capacity - depth, depth);
+  std::memcpy(buf + depth, tail, tail_length);
+  return depth + tail_length;
+}
+
+template <class BcT>
+std::string_view BasicDaTrieDic<BcT>::access(uint32_t str_id) const {
+  static thread_local std::vector<char> buf;
+  if (num_strs_ <= str_id) {
+    return std::string_view();
+  }
+  // At least a byte, so that middle is not null even if max_length_ is 0.
+  if (buf.size() < max_length_ * 2 + 1) {
+    buf.resize(max_length_ * 2 + 1);
+  }
+
+  // The path ends at the middle of buf and the tail follows it.
+  auto node_pos = to_node_pos_(str_id);
+  auto tail = &tail_[bc_.is_leaf(node_pos) ? bc_.link(node_pos) : 0];
+
+  auto middle = buf.data() + max_length_;
+  auto depth = write_path_(node_pos, middle, max_length_);
+  auto tail_length = std::strlen(tail);
+  std::memcpy(middle, tail, tail_length);
+  return std::string_view(middle - depth, depth + tail_length);
+}
+
+// path holds the nodes from the root to the last node decoded and str holds
+// their labels, which are kept for the next string. Climbing stops at the
+// first ancestor on path, found through a direct-mapped table of the depths,
+// so only the labels below it are decoded and the rest is copied from str.
+template <class BcT>
+void BasicDaTrieDic<BcT>::access_batch(const uint32_t *str_ids, size_t size,
+                                       std::string &bytes,
+                                       std::vector<size_t> &offsets) const {
+  bytes.clear();
+  offsets.assign(1, 0);
+  offsets.reserve(size + 1);
+
+  uint32_t bits = 8;
+  while ((size_t(1) << bits) < max_length_ * 4) {
+    ++bits;
+  }
+  std::vector<uint32_t> depths(size_t(1) << bits, 0);
+  auto depth_of = [&](uint32_t node_pos) -> uint32_t & {
+    return depths[(node_pos * 0x9E3779B9U) >> (32 - bits)];
+  };
+
+  std::vector<uint32_t> path{0}, nodes;
+  std::string str;
+  str.reserve(max_length_);
+
+  for (size_t i = 0; i < size; ++i) {
+    if (num_strs_ <= str_ids[i]) {
+      offsets.push_back(bytes.size());
+      continue;
+    }
+
+    auto node_pos = to_node_pos_(str_ids[i]);
+    nodes.clear();
+    while (node_pos != 0) {
+      auto depth = depth_of(node_pos);
+      if (depth < path.size() && path[depth] == node_pos) {
+        break;
+      }
+      nodes.push_back(node_pos);
+      node_pos = bc_.check(node_pos);
+    }
+    path.resize((node_pos == 0) ? 1 : depth_of(node_pos) + 1);
+    str.resize(path.size() - 1);
+
+    for (; !nodes.empty(); nodes.pop_back()) {
+      auto child_pos = nodes.back();
+      if (!labels_.is_empty()) {
+        str += static_cast<char>(labels_[child_pos]);
+      } else {
+        auto code = static_cast<uint8_t>(bc_.base(node_pos) ^ child_pos);
+        str += static_cast<char>(table_.label(code));
+      }
+      depth_of(child_pos) = static_cast<uint32_t>(path.size());
+      path.push_back(child_pos);
+      node_pos = child_pos;
+    }
+
+    bytes += str;
+    if (bc_.is_leaf(node_pos)) {
+      bytes += &tail_[bc_.link(node_pos)];
+    }
+    offsets.push_back(bytes.size());
+  }
+}
+
+template <class BcT>
+void BasicDaTrieDic<BcT>::enumerate(std::vector<uint32_t> &ret) const {
+  ret.clear();
+  if (num_strs_ == 0) {
+    return;
+  }
+  ret.reserve(num_strs_);
+  traverse_(0, [&](const frame_t &frame) {
+    if (term_flags_[frame.node_pos]) {
+      ret.push_back(to_str_id_(frame.node_pos));
+    }
+    return true;
+  });
+}
+
+template <class BcT>
+template <class Func>
+size_t BasicDaTrieDic<BcT>::enumerate(Func f) const {
+  return predictive_search(std::string_view(), f);
+}
+
+template <class BcT>
+size_t BasicDaTrieDic<BcT>::enumerate(
+  const std::function<bool(uint32_t, const std::string &)> &f) const {
+  return enumerate<decltype(f)>(f);
+}
+
+template <class BcT>
+template <class Func>
+size_t BasicDaTrieDic<BcT>::enumerate(uint32_t &node_pos, size_t size, Func f) const {
+  if (num_strs_ == 0 || !is_node_(node_pos)) {
+    node_pos = NOT_FOUND;
+    return 0;
+  }
+
+  std::string str(max_length_, '\0');
+  auto depth = write_path_(node_pos, &str[0] + max_length_, max_length_);
+  str.erase(0, max_length_ - depth);
+
+  size_t count = 0;
+  while (node_pos != NOT_FOUND && count < size) {
+    auto str_pos = node_pos;
+    auto is_terminal = term_flags_[str_pos];
+    auto length = str.size();
+    if (is_terminal && bc_.is_leaf(str_pos)) {
+      str += &tail_[bc_.link(str_pos)];
+    }
+    auto go_on = !is_terminal || f(to_str_id_(str_pos), static_cast<const std::string &>(str));
+    str.resize(length);
+    count += is_terminal;
+    node_pos = next_node_(node_pos, str);
+    if (!go_on) {
+      break;
+    }
+  }
+  return count;
+}
+
+template <class BcT>
+size_t BasicDaTrieDic<BcT>::enumerate(
+  uint32_t &node_pos, size_t size,
+  const std::function<bool(uint32_t, const std::string &)> &f) const {
+  return enumerate<decltype(f)>(node_pos, size, f);
+}
+
+// The links are computed in breadth-first order of the states, so that the
+// failure link of each state is settled before those of its children.
+template <class BcT>
+void BasicDaTrieDic<BcT>::build_scanner() {
+  ac_fails_.clear();
+  ac_outputs_.clear();
+  ac_tail_states_.clear();
+  ac_tail_ends_.clear();
+  ac_tail_leaves_.clear();
+  if (num_strs_ == 0) {
+    return;
+  }
+
+  std::vector<uint32_t> tail_states(bc_.size(), 0), tail_leaves;
+  std::vector<bool> tail_ends;
+  traverse_(0, [&](const frame_t &frame) {
+    if (bc_.is_leaf(frame.node_pos)) {
+      auto tail_length = std::strlen(&tail_[bc_.link(frame.node_pos)]);
+      if (tail_length != 0) {
+        tail_states[frame.node_pos] = static_cast<uint32_t>(bc_.size() + tail_ends.size());
+        tail_ends.insert(tail_ends.end(), tail_length, false);
+        tail_ends.back() = true;
+        tail_leaves.push_back(frame.node_pos);
+      }
+    }
+    return true;
+  });
+  ac_tail_states_.build(tail_states);
+  ac_tail_ends_.build(tail_ends);
+  ac_tail_leaves_.build(tail_leaves);
+
+  auto num_states = bc_.size() + tail_ends.size();
+  std::vector<uint32_t> fails(num_states, 0), outputs(num_states, 0);
+  std::vector<uint32_t> queue{0};
+  std::vector<frame_t> children;
+
+  auto visit = [&](uint32_t state, uint32_t child, uint8_t label) {
+    uint32_t fail = 0;
+    for (auto pos = fails[state]; state != 0; pos = fails[pos]) {
+      fail = ac_goto_(pos, label);
+      if (fail != 0 || pos == 0) {
+        break;
+      }
+    }
+    fails[child] = fail;
+    outputs[child] = ac_is_terminal_(fail) ? fail : outputs[fail];
+    queue.push_back(child);
+  };
+
+  for (size_t i = 0; i < queue.size(); ++i) {
+    auto state = queue[i];
+    uint32_t leaf_pos = 0;
+    auto tail = ac_tail_(state, leaf_pos);
+    if (tail == nullptr) {
+      children.clear();
+      push_children_(frame_t{state, 0, 0}, children);
+      for (auto it = children.rbegin(); it != children.rend(); ++it) {
+        visit(state, it->node_pos, it->label);
+      }
+    } else if (*tail != '\0') {
+      visit(state, ac_goto_(state, static_cast<uint8_t>(*tail)), static_cast<uint8_t>(*tail));
+    }
+  }
+
+  ac_fails_.build(fails);
+  ac_outputs_.build(outputs);
+}
+
+template <class BcT>
+template <class Func>
+void BasicDaTrieDic<BcT>::scan(const char *text, size_t length, Func f) const {
+  if (num_strs_ == 0) {
+    return;
+  }
+
+  if (ac_fails_.size() == 0) {
+    for (size_t begin = 0; begin <= length; ++begin) {
+      common_prefix_search(text + begin, length - begin, [&](const match_t &match) {
+        f(match_t{match.str_id, begin + match.length});
+      });
+    }
+    return;
+  }
+
+  // The empty key, which is not on any failure chain, ends at every offset.
+  auto root_id = ac_is_terminal_(0) ? ac_str_id_(0) : NOT_FOUND;
+  if (root_id != NOT_FOUND) {
+    f(match_t{root_id, 0});
+  }
+
+  uint32_t state = 0;
+  for (size_t i = 0; i < length; ++i) {
+    auto label = static_cast<uint8_t>(table_.fold(text[i]));
+    auto next = ac_goto_(state, label);
+    while (next == 0 && state != 0) {
+      state = ac_fails_[state];
+      next = ac_goto_(state, label);
+    }
+    state = next;
+    auto output = (state != 0 && ac_is_terminal_(state)) ? state : ac_outputs_[state];
+    for (; output != 0; output = ac_outputs_[output]) {
+      f(match_t{ac_str_id_(output), i + 1});
+    }
+    if (root_id != NOT_FOUND) {
+      f(match_t{root_id, i + 1});
+    }
+  }
+}
+
+template <class BcT>
+void BasicDaTrieDic<BcT>::scan(std::string_view text,
+                               const std::function<void(const match_t &)> &f) const {
+  scan<decltype(f)>(text.data(), text.size(), f);
+}
+
+template <class BcT>
+cursor_t BasicDaTrieDic<BcT>::cursor_root() const {
+  auto position = root_();
+  return cursor_t{position.node_pos, (position.tail == nullptr) ? NOT_FOUND : bc_.link(0)};
+}
+
+template <class BcT>
+uint32_t BasicDaTrieDic<BcT>::cursor_id(const cursor_t &cursor) const {
+  if (cursor.node_pos == NOT_FOUND) {
+    return NOT_FOUND;
+  }
+  auto is_terminal = (cursor.tail_pos == NOT_FOUND) ? term_flags_[cursor.node_pos]
+                                                    : tail_[cursor.tail_pos] == '\0';
+  return is_terminal ? to_str_id_(cursor.node_pos) : NOT_FOUND;
+}
+
+// The bytes fed are recovered by climbing from the node of cursor.
+template <class BcT>
+template <class Func>
+size_t BasicDaTrieDic<BcT>::cursor_predict(const cursor_t &cursor, Func f,
+                                           size_t limit) const {
+  if (cursor.node_pos == NOT_FOUND || limit == 0) {
+    return 0;
+  }
+
+  std::string str(max_length_, '\0');
+  auto depth = write_path_(cursor.node_pos, &str[0] + max_length_, max_length_);
+  str.erase(0, max_length_ - depth);
+  if (cursor.tail_pos != NOT_FOUND) {
+    str += &tail_[bc_.link(cursor.node_pos)];
+    f(to_str_id_(cursor.node_pos), static_cast<const std::string &>(str));
+    return 1;
+  }
+  return predict_(cursor.node_pos, str, f, limit);
+}
+
+template <class BcT>
+size_t BasicDaTrieDic<BcT>::cursor_predict(
+  const cursor_t &cursor, const std::function<bool(uint32_t, const std::string &)> &f,
+  size_t limit) const {
+  return cursor_predict<decltype(f)>(cursor, f, limit);
+}
+
+template <class BcT>
+void BasicDaTrieDic<BcT>::intersect(const TrieDic &other,
+                                    const std::function<void(uint32_t, uint32_t)> &f) const {
+  merge_(other, false, false, f);
+}
+
+template <class BcT>
+void BasicDaTrieDic<BcT>::difference(const TrieDic &other,
+                                     const std::function<void(uint32_t)> &f) const {
+  merge_(other, true, false, [&](uint32_t str_id, uint32_t other_id) {
+    if (other_id == NOT_FOUND) {
+      f(str_id);
+    }
+  });
+}
+
+template <class BcT>
+void BasicDaTrieDic<BcT>::merge(const TrieDic &other,
+                                const std::function<void(uint32_t, uint32_t)> &f) const {
+  merge_(other, true, true, f);
+}
+
+template <class BcT>
+size_t BasicDaTrieDic<BcT>::size_in_bytes() const {
+  size_t size = 0;
+  size += bc_.size_in_bytes();
+  size += term_flags_.size_in_bytes();
+  size += tail_.size_in_bytes();
+  size += table_.size_in_bytes();
+  size += labels_.size_in_bytes();
+  size += lex_ids_.size_in_bytes();
+  size += node_ids_.size_in_bytes();
+  size += internal_flags_.size_in_bytes();
+  size += child_labels_.size_in_bytes();
+  size += sibling_labels_.size_in_bytes();
+  size += counts_.size_in_bytes();
+  size += weights_.size_in_bytes();
+  size += max_weights_.size_in_bytes();
+  size += ac_fails_.size_in_bytes();
+  size += ac_outputs_.size_in_bytes();
+  size += ac_tail_states_.size_in_bytes();
+  size += ac_tail_ends_.size_in_bytes();
+  size += ac_tail_leaves_.size_in_bytes();
+  return size;
+}
+
+template <class BcT>
+void BasicDaTrieDic<BcT>::stat(std::ostream &os) const {
+  os << "Double-array trie dictionary stat..." << std::endl;
+  os << "num strs     : " << num_strs() << std::endl;
+  os << "bc size      : " << bc_size() << std::endl;
+  os << "tail size    : " << tail_size() << std::endl;
+  os << "size in bytes: " << size_in_bytes() << std::endl;
+  bc_.stat(os);
+}
+
+template <class BcT>
+void BasicDaTrieDic<BcT>::write(std::ostream &os) const {
+  auto type = static_cast<uint32_t>(BcT::TYPE);
+  os.write(reinterpret_cast<const char *>(&MAGIC), sizeof(MAGIC));
+  os.write(reinterpret_cast<const char *>(&VERSION), sizeof(VERSION));
+  os.write(reinterpret_cast<const char *>(&type), sizeof(type));
+  bc_.write(os);
+  term_flags_.write(os);
+  tail_.write(os);
+  table_.write(os);
+  labels_.write(os);
+  lex_ids_.write(os);
+  node_ids_.write(os);
+  internal_flags_.write(os);
+  child_labels_.write(os);
+  sibling_labels_.write(os);
+  counts_.write(os);
+  weights_.write(os);
+  max_weights_.write(os);
+  ac_fails_.write(os);
+  ac_outputs_.write(os);
+  ac_tail_states_.write(os);
+  ac_tail_ends_.write(os);
+  ac_tail_leaves_.write(os);
+  os.write(reinterpret_cast<const char *>(&order_), sizeof(order_));
+  os.write(reinterpret_cast<const char *>(&num_strs_), sizeof(num_strs_));
+  os.write(reinterpret_cast<const char *>(&max_length_), sizeof(max_length_));
+}
+
+template <class BcT>
+void BasicDaTrieDic<BcT>::read(std::istream &is) {
+  clear();
+  uint32_t magic = 0, version = 0, type = 0;
+  is.read(reinterpret_cast<char *>(&magic), sizeof(magic));
+  is.read(reinterpret_cast<char *>(&version), sizeof(version));
+  is.read(reinterpret_cast<char *>(&type), sizeof(type));
+  if (magic != MAGIC) {
+    std::cerr << "Critical error: dic is not in the format of cda-tries" << std::endl;
+    exit(1);
+  }
+  if (version != VERSION) {
+    std::cerr << "Critical error: dic format version " << version << " is not "
+              << VERSION << std::endl;
+    exit(1);
+  }
+  if (type != static_cast<uint32_t>(BcT::TYPE)) {
+    std::cerr << "Critical error: dic was written with another bc_type" << std::endl;
+    exit(1);
+  }
+  bc_.read(is);
+  term_flags_.read(is);
+  tail_.read(is);
+  table_.read(is);
+  labels_.read(is);
+  lex_ids_.read(is);
+  node_ids_.read(is);
+  internal_flags_.read(is);
+  child_labels_.read(is);
+  sibling_labels_.read(is);
+  counts_.read(is);
+  weights_.read(is);
+  max_weights_.read(is);
+  ac_fails_.read(is);
+  ac_outputs_.read(is);
+  ac_tail_states_.read(is);
+  ac_tail_ends_.read(is);
+  ac_tail_leaves_.read(is);
+  is.read(reinterpret_cast<char *>(&order_), sizeof(order_));
+  is.read(reinterpret_cast<char *>(&num_strs_), sizeof(num_strs_));
+  is.read(reinterpret_cast<char *>(&max_length_), sizeof(max_length_));
+}
+
+template <class BcT>
+void BasicDaTrieDic<BcT>::clear() {
+  bc_.clear();
+  term_flags_.clear();
+  tail_.clear();
+  table_.clear();
+  labels_.clear();
+  lex_ids_.clear();
+  node_ids_.clear();
+  internal_flags_.clear();
+  child_labels_.clear();
+  sibling_labels_.clear();
+  counts_.clear();
+  weights_.clear();
+  max_weights_.clear();
+  ac_fails_.clear();
+  ac_outputs_.clear();
+  ac_tail_states_.clear();
+  ac_tail_ends_.clear();
+  ac_tail_leaves_.clear();
+  order_      = id_order::PLACEMENT;
+  num_strs_   = 0;
+  max_length_ = 0;
+}
+
+// Runs the queries with id_pos in [0,size), keeping up to BATCH_SIZE of them
+// in flight. init(query) sets up a query whose id_pos is given, and
+// step(query) advances it by one transition and returns true when finished.
+template <class BcT>
+template <class Init, class Step>
+void BasicDaTrieDic<BcT>::run_batch_(size_t size, Init init, Step step) const {
+  query_t queries[BATCH_SIZE];
+  size_t num_queries = 0;
+  size_t next_pos = 0;
+
+  auto start = [&](query_t &query) {
+    query = query_t();
+    query.id_pos = next_pos++;
+    init(query);
+  };
+
+  while (num_queries < BATCH_SIZE && next_pos < size) {
+    start(queries[num_queries++]);
+  }
+
+  while (num_queries != 0) {
+    for (size_t i = 0; i < num_queries;) {
+      auto &query = queries[i];
+      if (!step(query)) {
+        ++i;
+      } else if (next_pos < size) {
+        start(query);
+        ++i;
+      } else {
+        query = queries[--num_queries];
+      }
+    }
+  }
+}
+
+// Writes the labels on the path from the root to node_pos backward into
+// [end-depth,end) as long as they fit in capacity, and returns the depth.
+template <class BcT>
+size_t BasicDaTrieDic<BcT>::write_path_(uint32_t node_pos, char *end,
+                                        size_t capacity) const {
+  size_t depth = 0;
+  while (node_pos != 0) {
+    auto parent_pos = bc_.check(node_pos);
+    if (++depth <= capacity) {
+      if (!labels_.is_empty()) {
+        *(end - depth) = static_cast<char>(labels_[node_pos]);
+      } else {
+        auto code = static_cast<uint8_t>(bc_.base(parent_pos) ^ node_pos);
+        *(end - depth) = static_cast<char>(table_.label(code));
+      }
+    }
+    node_pos = parent_pos;
+  }
+  return depth;
+}
+
+// Advances query by one transition. The element of a child is prefetched when
+// it is computed and verified at the next step, as is the tail. Returns true
+// when the query is finished and its result is set to id.
+template <class BcT>
+bool BasicDaTrieDic<BcT>::lookup_step_(query_t &query, uint32_t &id) const {
+  if (query.tail != nullptr) {
+    auto tail = query.tail;
+    auto str = query.str;
+    while (*tail != '\0' && str != query.end && *tail == table_.fold(*str)) {
+      ++tail;
+      ++str;
+    }
+    id = (*tail == '\0' && str == query.end) ? to_str_id_(query.node_pos) : NOT_FOUND;
+    return true;
+  }
+
+  if (query.child_pos != 0) {
+    if (bc_.check(query.child_pos) != query.node_pos) {
+      id = NOT_FOUND;
+      return true;
+    }
+    query.node_pos = query.child_pos;
+  }
+
+  auto node_pos = query.node_pos;
+  if (bc_.is_leaf(node_pos)) {
+    query.tail = &tail_[bc_.link(node_pos)];
+    Prefetch(query.tail);
+    term_flags_.prefetch(node_pos);
+    return false;
+  }
+  if (query.str == query.end) {
+    id = term_flags_[node_pos] ? to_str_id_(node_pos) : NOT_FOUND;
+    return true;
+  }
+
+  auto label = static_cast<uint8_t>(*query.str++);
+  query.child_pos = bc_.base(node_pos) ^ table_.code(label);
+  if (query.child_pos == 0) {
+    id = NOT_FOUND;
+    return true;
+  }
+  bc_.prefetch(query.child_pos);
+  return false;
+}
+
+// Same as lookup_step_ except that the deepest terminal node passed and its
+// depth are kept in query.term_pos and length.
+template <class BcT>
+bool BasicDaTrieDic<BcT>::longest_prefix_match_step_(query_t &query, match_t &ret) const {
+  auto finish = [&]() {
+    ret = (query.term_pos == NOT_FOUND) ? match_t{NOT_FOUND, 0}
+                                        : match_t{to_str_id_(query.term_pos), query.length};
+    return true;
+  };
+
+  if (query.tail != nullptr) {
+    auto tail = query.tail;
+    auto str = query.str;
+    while (*tail != '\0' && str != query.end && *tail == table_.fold(*str)) {
+      ++tail;
+      ++str;
+    }
+    if (*tail == '\0') {
+      query.term_pos = query.node_pos;
+      query.length = str - query.begin;
+    }
+    return finish();
+  }
+
+  if (query.child_pos != 0) {
+    if (bc_.check(query.child_pos) != query.node_pos) {
+      return finish();
+    }
+    query.node_pos = query.child_pos;
+  }
+
+  auto node_pos = query.node_pos;
+  if (bc_.is_leaf(node_pos)) {
+    query.tail = &tail_[bc_.link(node_pos)];
+    Prefetch(query.tail);
+    return false;
+  }
+  if (term_flags_[node_pos]) {
+    query.term_pos = node_pos;
+    query.length = query.str - query.begin;
+  }
+  if (query.str == query.end) {
+    return finish();
+  }
+
+  auto label = static_cast<uint8_t>(*query.str++);
+  query.child_pos = bc_.base(node_pos) ^ table_.code(label);
+  if (query.child_pos == 0) {
+    return finish();
+  }
+  bc_.prefetch(query.child_pos);
+  term_flags_.prefetch(query.child_pos);
+  return false;
+}
+
+// Pushes the children of the internal node of frame onto stack in descending
+// order so that the smallest is popped first. The children are followed
+// through the labels after build_child_index, otherwise only the labels used
+// in the keys are probed.
+template <class BcT>
+void BasicDaTrieDic<BcT>::push_children_(const frame_t &frame,
+                                         std::vector<frame_t> &stack) const {
+  auto base = bc_.base(frame.node_pos);
+  if (!child_labels_.is_empty()) {
+    auto begin = stack.size();
+    for (auto label = child_labels_[frame.node_pos]; label != 0;) {
+      auto child_pos = base ^ table_.code(label);
+      stack.push_back(frame_t{child_pos, frame.depth + 1, label});
+      label = sibling_labels_[child_pos];
+    }
+    std::reverse(stack.begin() + begin, stack.end());
+    return;
+  }
+  for (uint8_t label = UINT8_MAX;; --label) {
+    if (table_.is_used(label)) {
+      auto child_pos = base ^ table_.code(label);
+      if (child_pos != 0 && bc_.check(child_pos) == frame.node_pos) {
+        stack.push_back(frame_t{child_pos, frame.depth + 1, label});
+      }
+    }
+    if (label == 0) {
+      break;
+    }
+  }
+}
+
+// Visits the nodes in the subtree of node_pos in lexicographical order,
+// calling f(frame) until it returns false, where frame.depth is relative to
+// node_pos. The traversal uses an explicit stack instead of recursion.
+template <class BcT>
+template <class Func>
+void BasicDaTrieDic<BcT>::traverse_(uint32_t node_pos, Func f) const {
+  std::vector<frame_t> stack;
+  stack.reserve(max_length_ + table_.alphabet_size());
+  stack.push_back(frame_t{node_pos, 0, 0});
+  traverse_(stack, f);
+}
+
+// Same as above, but resumes the traversal from the frames in stack.
+template <class BcT>
+template <class Func>
+void BasicDaTrieDic<BcT>::traverse_(std::vector<frame_t> &stack, Func f) const {
+  while (!stack.empty()) {
+    auto frame = stack.back();
+    stack.pop_back();
+
+    if (!f(frame)) {
+      return;
+    }
+    if (!bc_.is_leaf(frame.node_pos)) {
+      push_children_(frame, stack);
+    }
+  }
+}
+
+// Builds an index of the internal nodes from node_values, where the value of
+// each node is merged into its parent from the deepest. internal_flags_ is
+// shared by the indexes and built at the first time.
+template <class BcT>
+template <class Merge>
+void BasicDaTrieDic<BcT>::build_node_index_(std::vector<uint32_t> &node_values, Merge merge,
+                                            SmallArray &ret) {
+  std::vector<uint32_t> node_ids;
+  traverse_(0, [&](const frame_t &frame) {
+    node_ids.push_back(frame.node_pos);
+    return true;
+  });
+
+  // Every node comes after all its descendants in the reverse of the preorder.
+  std::vector<bool> internal_flags(bc_.size(), false);
+  for (auto it = node_ids.rbegin(); it != node_ids.rend(); ++it) {
+    auto node_pos = *it;
+    internal_flags[node_pos] = !bc_.is_leaf(node_pos);
+    if (node_pos != 0) {
+      auto &parent_value = node_values[bc_.check(node_pos)];
+      parent_value = merge(parent_value, node_values[node_pos]);
+    }
+  }
+
+  std::vector<uint32_t> values;
+  for (uint32_t node_pos = 0; node_pos < bc_.size(); ++node_pos) {
+    if (internal_flags[node_pos]) {
+      values.push_back(node_values[node_pos]);
+    }
+  }
+  if (internal_flags_.size() == 0) {
+    internal_flags_.build(internal_flags);
+  }
+  ret.build(values);
+}
+
+// Calls f(node_pos, str) for each key str not less than key (greater than
+// key if !inclusive) in lexicographical order, until f returns false. The
+// descent along key pushes, at each node, the children with labels greater
+// than that of key, so that the traversal pops them after the subtree on the
+// path of key, in increasing order.
+template <class BcT>
+template <class Func>
+void BasicDaTrieDic<BcT>::scan_(std::string_view key, bool inclusive, Func f) const {
+  if (num_strs_ == 0) {
+    return;
+  }
+
+  std::string str;
+  str.reserve(std::max(max_length_, key.size()));
+  for (auto c : key) {
+    str += table_.fold(c);
+  }
+
+  std::vector<frame_t> stack;
+  stack.reserve(key.size() + max_length_ + table_.alphabet_size());
+
+  frame_t frame{0, 0, 0};
+  while (true) {
+    if (bc_.is_leaf(frame.node_pos)) {
+      auto tail = &tail_[bc_.link(frame.node_pos)];
+      auto cmp = std::string_view(tail).compare(std::string_view(str).substr(frame.depth));
+      if (0 < cmp || (cmp == 0 && inclusive)) {
+        stack.push_back(frame);
+      }
+      break;
+    }
+    if (frame.depth == str.size()) {
+      if (inclusive) {
+        stack.push_back(frame);
+      } else {
+        push_children_(frame, stack);
+      }
+      break;
+    }
+
+    auto label = static_cast<uint8_t>(str[frame.depth]);
+    auto base = bc_.base(frame.node_pos);
+    for (uint32_t greater = UINT8_MAX; label < greater; --greater) {
+      if (table_.is_used(static_cast<uint8_t>(greater))) {
+        auto child_pos = base ^ table_.code(static_cast<uint8_t>(greater));
+        if (child_pos != 0 && bc_.check(child_pos) == frame.node_pos) {
+          stack.push_back(frame_t{child_pos, frame.depth + 1,
+                                  static_cast<uint8_t>(greater)});
+        }
+      }
+    }
+    auto child_pos = base ^ table_.code(label);
+    if (child_pos == 0 || bc_.check(child_pos) != frame.node_pos) {
+      break;
+    }
+    frame = frame_t{child_pos, frame.depth + 1, label};
+  }
+
+  // The popped frames are never shallower than the previous ones on the path
+  // of key, so str keeps the labels of their ancestors.
+  traverse_(stack, [&](const frame_t &frame) {
+    str.resize(frame.depth);
+    if (frame.depth != 0) {
+      str.back() = static_cast<char>(frame.label);
+    }
+    if (!term_flags_[frame.node_pos]) {
+      return true;
+    }
+    if (bc_.is_leaf(frame.node_pos)) {
+      str += &tail_[bc_.link(frame.node_pos)];
+    }
+    return f(frame.node_pos, static_cast<const std::string &>(str));
+  });
+}
+
+template <class BcT>
+typename BasicDaTrieDic<BcT>::position_t BasicDaTrieDic<BcT>::root_() const {
+  if (num_strs_ == 0) {
+    return position_t();
+  }
+  return position_t{0, bc_.is_leaf(0) ? &tail_[bc_.link(0)] : nullptr};
+}
+
+template <class BcT>
+typename BasicDaTrieDic<BcT>::position_t
+BasicDaTrieDic<BcT>::child_(const position_t &position, uint8_t label) const {
+  if (position.tail != nullptr) {
+    if (*position.tail == '\0' || static_cast<uint8_t>(*position.tail) != label) {
+      return position_t();
+    }
+    return position_t{position.node_pos, position.tail + 1};
+  }
+  auto child_pos = bc_.base(position.node_pos) ^ table_.code(label);
+  if (child_pos == 0 || bc_.check(child_pos) != position.node_pos) {
+    return position_t();
+  }
+  return position_t{child_pos, bc_.is_leaf(child_pos) ? &tail_[bc_.link(child_pos)] : nullptr};
+}
+
+// Returns the position reached by the folded labels of prefix from the root.
+template <class BcT>
+typename BasicDaTrieDic<BcT>::position_t
+BasicDaTrieDic<BcT>::descend_(std::string_view prefix) const {
+  auto position = root_();
+  for (size_t i = 0; i < prefix.size() && position.node_pos != NOT_FOUND; ++i) {
+    position = child_(position, static_cast<uint8_t>(table_.fold(prefix[i])));
+  }
+  return position;
+}
+
+template <class BcT>
+bool BasicDaTrieDic<BcT>::is_terminal_(const position_t &position) const {
+  return (position.tail != nullptr) ? *position.tail == '\0' : term_flags_[position.node_pos];
+}
+
+// Collects the children of position into ret in decreasing order of label,
+// where frames is a buffer for push_children_.
+template <class BcT>
+void BasicDaTrieDic<BcT>::children_(const position_t &position, std::vector<frame_t> &frames,
+                                    std::vector<edge_t> &ret) const {
+  ret.clear();
+  if (position.tail != nullptr) {
+    if (*position.tail != '\0') {
+      ret.push_back(edge_t{static_cast<uint8_t>(*position.tail),
+                           position_t{position.node_pos, position.tail + 1}});
+    }
+    return;
+  }
+  frames.clear();
+  push_children_(frame_t{position.node_pos, 0, 0}, frames);
+  for (auto &frame : frames) {
+    auto tail = bc_.is_leaf(frame.node_pos) ? &tail_[bc_.link(frame.node_pos)] : nullptr;
+    ret.push_back(edge_t{frame.label, position_t{frame.node_pos, tail}});
+  }
+}
+
+// Calls f(str_id) for each key under position in lexicographical order.
+template <class BcT>
+template <class Func>
+void BasicDaTrieDic<BcT>::for_each_id_(const position_t &position, Func f) const {
+  if (position.tail != nullptr) {
+    f(to_str_id_(position.node_pos));
+    return;
+  }
+  traverse_(position.node_pos, [&](const frame_t &frame) {
+    if (term_flags_[frame.node_pos]) {
+      f(to_str_id_(frame.node_pos));
+    }
+    return true;
+  });
+}
+
+template <class BcT>
+template <class Func>
+void BasicDaTrieDic<BcT>::merge_(const TrieDic &other, bool lhs_only, bool rhs_only,
+                                 Func f) const {
+  switch (other.type()) {
+    case bc_type::PLAIN:
+      merge_(static_cast<const BasicDaTrieDic<PlainBc> &>(other), lhs_only, rhs_only, f);
+      break;
+    case bc_type::DAC:
+      merge_(static_cast<const BasicDaTrieDic<DacBc> &>(other), lhs_only, rhs_only, f);
+      break;
+    case bc_type::FDAC:
+      merge_(static_cast<const BasicDaTrieDic<FastDacBc> &>(other), lhs_only, rhs_only, f);
+      break;
+  }
+}
+
+// Traverses the pairs of the positions for the same string in this and
+// other. A pair with a missing side is reported as a whole if lhs_only or
+// rhs_only requests its side, and skipped otherwise, so that an intersection
+// never enters the subtrees on one side. Each label is looked up in the code
+// table of each side.
+template <class BcT>
+template <class OtherBcT, class Func>
+void BasicDaTrieDic<BcT>::merge_(const BasicDaTrieDic<OtherBcT> &other, bool lhs_only,
+                                 bool rhs_only, Func f) const {
+  using other_t = BasicDaTrieDic<OtherBcT>;
+  struct pair_t {
+    position_t lhs;
+    typename other_t::position_t rhs;
+  };
+  std::vector<frame_t> lhs_frames;
+  std::vector<edge_t> lhs_edges;
+  std::vector<typename other_t::frame_t> rhs_frames;
+  std::vector<typename other_t::edge_t> rhs_edges;
+
+  std::vector<pair_t> stack;
+  stack.push_back(pair_t{root_(), other.root_()});
+
+  while (!stack.empty()) {
+    auto pair = stack.back();
+    stack.pop_back();
+
+    auto &lhs = pair.lhs;
+    auto &rhs = pair.rhs;
+    if (rhs.node_pos == NOT_FOUND) {
+      if (lhs.node_pos != NOT_FOUND && lhs_only) {
+        for_each_id_(lhs, [&](uint32_t str_id) {
+          f(str_id, NOT_FOUND);
+        });
+      }
+      continue;
+    }
+    if (lhs.node_pos == NOT_FOUND) {
+      if (rhs_only) {
+        other.for_each_id_(rhs, [&](uint32_t str_id) {
+          f(NOT_FOUND, str_id);
+        });
+      }
+      continue;
+    }
+
+    // The rests of two tails are compared at once.
+    if (lhs.tail != nullptr && rhs.tail != nullptr) {
+      auto cmp = std::strcmp(lhs.tail, rhs.tail);
+      auto lhs_id = to_str_id_(lhs.node_pos);
+      auto rhs_id = other.to_str_id_(rhs.node_pos);
+      if (cmp == 0) {
+        f(lhs_id, rhs_id);
+        continue;
+      }
+      if (cmp < 0 && lhs_only) {
+        f(lhs_id, NOT_FOUND);
+      }
+      if (rhs_only) {
+        f(NOT_FOUND, rhs_id);
+      }
+      if (0 < cmp && lhs_only) {
+        f(lhs_id, NOT_FOUND);
+      }
+      continue;
+    }
+    // The rest of a tail is looked up from the node on the other side unless
+    // the other keys under it are requested.
+    if (lhs.tail != nullptr && !rhs_only) {
+      auto tail = lhs.tail;
+      while (*tail != '\0' && rhs.node_pos != NOT_FOUND) {
+        rhs = other.child_(rhs, static_cast<uint8_t>(*tail++));
+      }
+      if (rhs.node_pos != NOT_FOUND && other.is_terminal_(rhs)) {
+        f(to_str_id_(lhs.node_pos), other.to_str_id_(rhs.node_pos));
+      } else if (lhs_only) {
+        f(to_str_id_(lhs.node_pos), NOT_FOUND);
+      }
+      continue;
+    }
+    if (rhs.tail != nullptr && !lhs_only) {
+      auto tail = rhs.tail;
+      while (*tail != '\0' && lhs.node_pos != NOT_FOUND) {
+        lhs = child_(lhs, static_cast<uint8_t>(*tail++));
+      }
+      if (lhs.node_pos != NOT_FOUND && is_terminal_(lhs)) {
+        f(to_str_id_(lhs.node_pos), other.to_str_id_(rhs.node_pos));
+      } else if (rhs_only) {
+        f(NOT_FOUND, other.to_str_id_(rhs.node_pos));
+      }
+      continue;
+    }
+
+    auto lhs_terminal = is_terminal_(lhs);
+    auto rhs_terminal = other.is_terminal_(rhs);
+    if (lhs_terminal && rhs_terminal) {
+      f(to_str_id_(lhs.node_pos), other.to_str_id_(rhs.node_pos));
+    } else if (lhs_terminal && lhs_only) {
+      f(to_str_id_(lhs.node_pos), NOT_FOUND);
+    } else if (rhs_terminal && rhs_only) {
+      f(NOT_FOUND, other.to_str_id_(rhs.node_pos));
+    }
+
+    // The children of both sides are merged in decreasing order of label, so
+    // that the smallest one is popped first.
+    children_(lhs, lhs_frames, lhs_edges);
+    other.children_(rhs, rhs_frames, rhs_edges);
+    size_t i = 0, j = 0;
+    while (i < lhs_edges.size() || j < rhs_edges.size()) {
+      pair_t child;
+      if (j == rhs_edges.size()
+          || (i < lhs_edges.size() && lhs_edges[i].label > rhs_edges[j].label)) {
+        child.lhs = lhs_edges[i++].child;
+      } else if (i == lhs_edges.size() || lhs_edges[i].label < rhs_edges[j].label) {
+        child.rhs = rhs_edges[j++].child;
+      } else {
+        child.lhs = lhs_edges[i++].child;
+        child.rhs = rhs_edges[j++].child;
+      }
+      if ((child.lhs.node_pos != NOT_FOUND && (lhs_only || child.rhs.node_pos != NOT_FOUND))
+          || (child.rhs.node_pos != NOT_FOUND && rhs_only)) {
+        stack.push_back(child);
+      }
+    }
+  }
+}
+
+// Calls f(str_id, str) for each key in the subtree of node_pos in
+// lexicographical order as predictive_search, where str holds the path to
+// node_pos.
+template <class BcT>
+template <class Func>
+size_t BasicDaTrieDic<BcT>::predict_(uint32_t node_pos, std::string &str, Func f,
+                                     size_t limit) const {
+  auto length = str.size();
+  size_t count = 0;
+  traverse_(node_pos, [&](const frame_t &frame) {
+    str.resize(length + frame.depth);
+    if (frame.depth != 0) {
+      str.back() = static_cast<char>(frame.label);
+    }
+    if (!term_flags_[frame.node_pos]) {
+      return true;
+    }
+    if (bc_.is_leaf(frame.node_pos)) {
+      str += &tail_[bc_.link(frame.node_pos)];
+    }
+    ++count;
+    return f(to_str_id_(frame.node_pos), static_cast<const std::string &>(str))
+           && count != limit;
+  });
+  return count;
+}
+
+// path[d] is the node reached by the first d bytes of the previous string,
+// up to the last node it reached, which may be a leaf.
+template <class BcT>
+template <class Get>
+void BasicDaTrieDic<BcT>::lookup_sorted_(size_t size, Get get, uint32_t *ids) const {
+  if (num_strs_ == 0) {
+    std::fill(ids, ids + size, NOT_FOUND);
+    return;
+  }
+
+  std::vector<uint32_t> path{0};
+  std::string_view prev;
+  for (size_t i = 0; i < size; ++i) {
+    auto str = get(i);
+    size_t depth = 0;
+    auto max_depth = std::min(std::min(prev.size(), str.size()), path.size() - 1);
+    while (depth < max_depth && prev[depth] == str[depth]) {
+      ++depth;
+    }
+    path.resize(depth + 1);
+    prev = str;
+
+    auto node_pos = path.back();
+    ids[i] = NOT_FOUND;
+    while (!bc_.is_leaf(node_pos)) {
+      if (depth == str.size()) {
+        ids[i] = term_flags_[node_pos] ? to_str_id_(node_pos) : NOT_FOUND;
+        break;
+      }
+      auto label = static_cast<uint8_t>(str[depth++]);
+      auto child_pos = bc_.base(node_pos) ^ table_.code(label);
+      if (child_pos == 0 || bc_.check(child_pos) != node_pos) {
+        break;
+      }
+      node_pos = child_pos;
+      path.push_back(node_pos);
+    }
+    if (!bc_.is_leaf(node_pos)) {
+      continue;
+    }
+
+    auto tail = &tail_[bc_.link(node_pos)];
+    for (; depth < str.size(); ++depth, ++tail) {
+      if (*tail == '\0' || *tail != table_.fold(str[depth])) {
+        break;
+      }
+    }
+    if (depth == str.size() && *tail == '\0') {
+      ids[i] = to_str_id_(node_pos);
+    }
+  }
+}
+
+// Returns the node after node_pos in preorder, or NOT_FOUND if there is none,
+// updating str from the path of node_pos to that of the returned node. The
+// next sibling is found by probing the labels after the last one in str.
+template <class BcT>
+uint32_t BasicDaTrieDic<BcT>::next_node_(uint32_t node_pos, std::string &str) const {
+  if (!child_labels_.is_empty()) {
+    if (!bc_.is_leaf(node_pos)) {
+      auto label = child_labels_[node_pos];
+      str += static_cast<char>(label);
+      return bc_.base(node_pos) ^ table_.code(label);
+    }
+    for (; node_pos != 0; str.pop_back()) {
+      auto label = sibling_labels_[node_pos];
+      node_pos = bc_.check(node_pos);
+      if (label != 0) {
+        str.back() = static_cast<char>(label);
+        return bc_.base(node_pos) ^ table_.code(label);
+      }
+    }
+    return NOT_FOUND;
+  }
+
+  uint32_t label = 0;
+  if (bc_.is_leaf(node_pos)) {
+    if (node_pos == 0) {
+      return NOT_FOUND;
+    }
+    label = static_cast<uint8_t>(str.back()) + 1;
+    str.pop_back();
+    node_pos = bc_.check(node_pos);
+  }
+
+  while (true) {
+    auto base = bc_.base(node_pos);
+    for (; label <= UINT8_MAX; ++label) {
+      if (table_.is_used(static_cast<uint8_t>(label))) {
+        auto child_pos = base ^ table_.code(static_cast<uint8_t>(label));
+        if (child_pos != 0 && bc_.check(child_pos) == node_pos) {
+          str += static_cast<char>(label);
+          return child_pos;
+        }
+      }
+    }
+    if (node_pos == 0) {
+      return NOT_FOUND;
+    }
+    label = static_cast<uint8_t>(str.back()) + 1;
+    str.pop_back();
+    node_pos = bc_.check(node_pos);
+  }
+}
+
+// Returns true if node_pos is reached from the root, which guards the climbing
+// from a node_pos given by the user.
+template <class BcT>
+bool BasicDaTrieDic<BcT>::is_node_(uint32_t node_pos) const {
+  for (size_t depth = 0; depth <= max_length_; ++depth) {
+    if (node_pos == 0) {
+      return true;
+    }
+    if (bc_.size() <= node_pos) {
+      return false;
+    }
+    auto parent_pos = bc_.check(node_pos);
+    if (bc_.size() <= parent_pos || bc_.is_leaf(parent_pos)) {
+      return false;
+    }
+    auto code = bc_.base(parent_pos) ^ node_pos;
+    if (UINT8_MAX < code || !table_.is_used(table_.label(static_cast<uint8_t>(code)))) {
+      return false;
+    }
+    node_pos = parent_pos;
+  }
+  return false;
+}
+
+// Returns the rest of the tail at state, or nullptr if state is an internal
+// node, setting leaf_pos to the node of state.
+template <class BcT>
+const char *BasicDaTrieDic<BcT>::ac_tail_(uint32_t state, uint32_t &leaf_pos) const {
+  if (state < bc_.size()) {
+    leaf_pos = state;
+    return bc_.is_leaf(state) ? &tail_[bc_.link(state)] : nullptr;
+  }
+  leaf_pos = ac_tail_leaves_[ac_tail_ends_.rank(state - static_cast<uint32_t>(bc_.size()))];
+  return &tail_[bc_.link(leaf_pos) + state - ac_tail_states_[leaf_pos] + 1];
+}
+
+// Returns the state reached from state by label, or 0 if there is none.
+template <class BcT>
+uint32_t BasicDaTrieDic<BcT>::ac_goto_(uint32_t state, uint8_t label) const {
+  uint32_t leaf_pos = 0;
+  auto tail = ac_tail_(state, leaf_pos);
+  if (tail == nullptr) {
+    auto child_pos = bc_.base(state) ^ table_.code(label);
+    return (child_pos == 0 || bc_.check(child_pos) != state) ? 0 : child_pos;
+  }
+  if (*tail == '\0' || static_cast<uint8_t>(*tail) != label) {
+    return 0;
+  }
+  return (state < bc_.size()) ? ac_tail_states_[state] : state + 1;
+}
+
+template <class BcT>
+bool BasicDaTrieDic<BcT>::ac_is_terminal_(uint32_t state) const {
+  if (bc_.size() <= state) {
+    return ac_tail_ends_[state - static_cast<uint32_t>(bc_.size())];
+  }
+  uint32_t leaf_pos = 0;
+  auto tail = ac_tail_(state, leaf_pos);
+  return (tail == nullptr) ? term_flags_[state] : *tail == '\0';
+}
+
+template <class BcT>
+uint32_t BasicDaTrieDic<BcT>::ac_str_id_(uint32_t state) const {
+  uint32_t leaf_pos = 0;
+  ac_tail_(state, leaf_pos);
+  return to_str_id_(leaf_pos);
+}
+
+extern template class BasicDaTrieDic<PlainBc>;
+extern template class BasicDaTrieDic<DacBc>;
+extern template class BasicDaTrieDic<FastDacBc>;
+
+} // cda_tries
+
+#endif // CDA_TRIES_BASIC_DA_TRIE_DIC_HPP
@@ -17,6 +17,7 @@ public:
   virtual uint32_t check(uint32_t pos) const = 0;
   virtual bool is_leaf(uint32_t pos) const = 0;
   virtual bool is_fixed(uint32_t pos) const = 0;
+  virtual void prefetch(uint32_t pos) const = 0;
 
   virtual size_t size() const = 0;
   virtual size_t size_in_bytes() const = 0;
@@ -201,12 +201,6 @@ void BitArray::build(const std::vector<bool> &bits) {
   num_1s_ = sum;
 }
 
-uint32_t BitArray::rank(uint32_t pos) const {
-  auto &block = blocks_[pos / R1_SIZE];
-  return block.rank_1st + block.rank_2nd[pos / R2_SIZE % R1_PER_R2]
-         + PopCount(bits_[pos / 32] & ((1U << (pos % 32)) - 1));
-}
-
 uint32_t BitArray::select(uint32_t count) const {
   ++count;
 
@@ -20,9 +20,19 @@ public:
     return (bits_[pos / 32] & (1U << (pos % 32))) != 0;
   }
 
-  uint32_t rank(uint32_t pos) const; // # of 1s in B[0,pos)
+  uint32_t rank(uint32_t pos) const { // # of 1s in B[0,pos)
+    auto &block = blocks_[pos / R1_SIZE];
+    return block.rank_1st + block.rank_2nd[pos / R2_SIZE % R1_PER_R2]
+           + PopCount(bits_[pos / 32] & ((1U << (pos % 32)) - 1));
+  }
   uint32_t select(uint32_t count) const; // pos of the count+1 th occurrence
 
+  // Prefetches the cache lines touched by operator[] and rank.
+  void prefetch(uint32_t pos) const {
+    Prefetch(&bits_[pos / 32]);
+    Prefetch(&blocks_[pos / R1_SIZE]);
+  }
+
   size_t size() const;
   size_t size_in_bytes() const;
 
@@ -0,0 +1,76 @@
+#include <algorithm>
+
+#include "BlobArray.hpp"
+
+namespace cda_tries {
+
+BlobArray::BlobArray() {}
+
+BlobArray::~BlobArray() {}
+
+void BlobArray::build(const std::vector<std::string> &blobs) {
+  clear();
+  if (blobs.empty()) {
+    return;
+  }
+
+  size_t num_bytes = 0;
+  for (auto &blob : blobs) {
+    num_bytes += blob.size();
+  }
+  bytes_.reset(num_bytes);
+
+  // The offset of the end of the last blob is stored as the (size+1)-th one.
+  std::vector<uint32_t> bases;
+  std::vector<uint32_t> rel_offsets;
+  bases.reserve(blobs.size() / BLOCK_SIZE + 1);
+  rel_offsets.reserve(blobs.size() + 1);
+
+  uint32_t offset = 0;
+  for (size_t i = 0; i <= blobs.size(); ++i) {
+    if (i % BLOCK_SIZE == 0) {
+      bases.push_back(offset);
+    }
+    rel_offsets.push_back(offset - bases.back());
+    if (i < blobs.size()) {
+      std::copy(blobs[i].begin(), blobs[i].end(), &bytes_[offset]);
+      offset += static_cast<uint32_t>(blobs[i].size());
+    }
+  }
+
+  bases_.build(bases);
+  rel_offsets_.build(rel_offsets);
+}
+
+size_t BlobArray::size() const {
+  return rel_offsets_.size() == 0 ? 0 : rel_offsets_.size() - 1;
+}
+
+size_t BlobArray::size_in_bytes() const {
+  size_t size = 0;
+  size += bytes_.size_in_bytes();
+  size += bases_.size_in_bytes();
+  size += rel_offsets_.size_in_bytes();
+  return size;
+}
+
+void BlobArray::write(std::ostream &os) const {
+  bytes_.write(os);
+  bases_.write(os);
+  rel_offsets_.write(os);
+}
+
+void BlobArray::read(std::istream &is) {
+  clear();
+  bytes_.read(is);
+  bases_.read(is);
+  rel_offsets_.read(is);
+}
+
+void BlobArray::clear() {
+  bytes_.clear();
+  bases_.clear();
+  rel_offsets_.clear();
+}
+
+} // cda_tries
@@ -0,0 +1,51 @@
+#ifndef CDA_TRIES_BLOB_ARRAY_HPP
+#define CDA_TRIES_BLOB_ARRAY_HPP
+
+#include "SmallArray.hpp"
+
+namespace cda_tries {
+
+// Array of variable-length byte strings. The offsets are kept as absolute
+// values at every BLOCK_SIZE entries and packed offsets relative to them.
+class BlobArray {
+public:
+  static constexpr uint32_t BLOCK_SIZE = 64;
+
+  BlobArray();
+  ~BlobArray();
+
+  void build(const std::vector<std::string> &blobs);
+
+  std::string_view operator[](uint32_t pos) const {
+    auto begin = offset_(pos);
+    auto end = offset_(pos + 1);
+    if (begin == end) {
+      return std::string_view();
+    }
+    return std::string_view(&bytes_[begin], end - begin);
+  }
+
+  size_t size() const;
+  size_t size_in_bytes() const;
+
+  void write(std::ostream &os) const;
+  void read(std::istream &is);
+
+  void clear();
+
+  BlobArray(const BlobArray &) = delete;
+  BlobArray &operator=(const BlobArray &) = delete;
+
+private:
+  Array<char> bytes_;
+  Array<uint32_t> bases_;
+  SmallArray rel_offsets_;
+
+  uint32_t offset_(uint32_t pos) const {
+    return bases_[pos / BLOCK_SIZE] + rel_offsets_[pos];
+  }
+};
+
+} // cda_tries
+
+#endif // CDA_TRIES_BLOB_ARRAY_HPP
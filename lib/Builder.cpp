@@ -288,6 +288,9 @@ void Builder::unify_tail_() {
 
   std::sort(suffixes_.begin(), suffixes_.end(), comp_suffix);
   tail_.push_back('\0');
+  if (suffixes_.empty()) {
+    return;
+  }
 
   size_t begin = 0;
   for (size_t i = 1; i < suffixes_.size(); ++i) {
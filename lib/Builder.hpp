@@ -8,7 +8,7 @@ namespace cda_tries {
 
 class Builder {
 public:
-  friend class DaTrieDic;
+  template <class BcT> friend class BasicDaTrieDic;
 
   static constexpr uint32_t FREE_BLOCKS = 16;
 
@@ -1,10 +1,26 @@
-#include <array>
 #include <algorithm>
+#include <iostream>
 
 #include "CodeTable.hpp"
 
 namespace cda_tries {
 
+fold_map_t IdentityFoldMap() {
+  fold_map_t fold_map;
+  for (uint32_t label = 0; label < 256; ++label) {
+    fold_map[label] = static_cast<uint8_t>(label);
+  }
+  return fold_map;
+}
+
+fold_map_t AsciiCaseFoldMap() {
+  auto fold_map = IdentityFoldMap();
+  for (uint32_t label = 'A'; label <= 'Z'; ++label) {
+    fold_map[label] = static_cast<uint8_t>(label - 'A' + 'a');
+  }
+  return fold_map;
+}
+
 CodeTable::CodeTable() { clear(); }
 
 CodeTable::~CodeTable() {}
@@ -17,11 +33,18 @@ struct freq_t {
   }
 };
 
-size_t CodeTable::build(const std::vector<std::string> &strs) {
+size_t CodeTable::build(const std::vector<std::string> &strs, const fold_map_t &fold_map) {
   if (strs.empty()) {
     return 0;
   }
 
+  for (uint32_t label = 0; label < 256; ++label) {
+    if (fold_map[fold_map[label]] != fold_map[label]) {
+      std::cerr << "Critical error: fold map is not idempotent" << std::endl;
+      exit(1);
+    }
+  }
+
   std::array<freq_t, 256> freqs;
 
   for (uint8_t label = 0;; ++label) {
@@ -41,6 +64,11 @@ size_t CodeTable::build(const std::vector<std::string> &strs) {
 
   std::sort(freqs.begin(), freqs.end());
 
+  alphabet_size_ = 0;
+  while (alphabet_size_ < 256 && freqs[alphabet_size_].freq != 0) {
+    ++alphabet_size_;
+  }
+
   for (uint8_t label = 0;; ++label) {
     table_[freqs[label].label] = label;
     if (label == UINT8_MAX) {
@@ -55,6 +83,11 @@ size_t CodeTable::build(const std::vector<std::string> &strs) {
     }
   }
 
+  // The codes of the folded labels are left unused.
+  for (uint32_t label = 0; label < 256; ++label) {
+    table_[label] = table_[fold_map[label]];
+  }
+
   return max_length;
 }
 
@@ -62,16 +95,22 @@ size_t CodeTable::size() const {
   return 512;
 }
 
+size_t CodeTable::alphabet_size() const {
+  return alphabet_size_;
+}
+
 size_t CodeTable::size_in_bytes() const {
   return sizeof(table_);
 }
 
 void CodeTable::write(std::ostream &os) const {
   os.write(reinterpret_cast<const char *>(&table_[0]), sizeof(table_));
+  os.write(reinterpret_cast<const char *>(&alphabet_size_), sizeof(alphabet_size_));
 }
 
 void CodeTable::read(std::istream &is) {
   is.read(reinterpret_cast<char *>(&table_[0]), sizeof(table_));
+  is.read(reinterpret_cast<char *>(&alphabet_size_), sizeof(alphabet_size_));
 }
 
 void CodeTable::clear() {
@@ -82,6 +121,7 @@ void CodeTable::clear() {
       break;
     }
   }
+  alphabet_size_ = 0;
 }
 
 } // cda_tries
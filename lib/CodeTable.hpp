@@ -1,16 +1,28 @@
 #ifndef CDA_TRIES_CODE_TABLE_HPP
 #define CDA_TRIES_CODE_TABLE_HPP
 
+#include <array>
+
 #include "Basic.hpp"
 
 namespace cda_tries {
 
+// Normalization of labels, where fold_map_t[label] is the representative
+// label of label. It must be idempotent.
+using fold_map_t = std::array<uint8_t, 256>;
+
+fold_map_t IdentityFoldMap();
+fold_map_t AsciiCaseFoldMap();
+
 class CodeTable {
 public:
   CodeTable();
   ~CodeTable();
 
-  size_t build(const std::vector<std::string> &strs);
+  // Builds from strs consisting of the representative labels of fold_map.
+  // Each of the other labels is given the code of its representative.
+  size_t build(const std::vector<std::string> &strs,
+               const fold_map_t &fold_map = IdentityFoldMap());
 
   uint8_t code(uint8_t label) const {
     return table_[label];
@@ -18,8 +30,18 @@ public:
   uint8_t label(uint8_t code) const {
     return table_[code + 256];
   }
+  // Returns the representative label of label.
+  char fold(char label) const {
+    return static_cast<char>(table_[table_[static_cast<uint8_t>(label)] + 256]);
+  }
+  // Representative labels in strs have codes in [0,alphabet_size), so
+  // traversals can skip the other labels.
+  bool is_used(uint8_t label) const {
+    return table_[label] < alphabet_size_ && table_[table_[label] + 256] == label;
+  }
 
   size_t size() const;
+  size_t alphabet_size() const;
   size_t size_in_bytes() const;
 
   void write(std::ostream &os) const;
@@ -32,6 +54,7 @@ public:
 
 private:
   uint8_t table_[512] = {};
+  uint32_t alphabet_size_ = 0;
 };
 
 } // cda_tries
@@ -0,0 +1,27 @@
+#include "Cursor.hpp"
+
+namespace cda_tries {
+
+Cursor::Cursor(const DaTrieDic &dic) : dic_(dic), cursor_(dic.cursor_root()) {}
+
+Cursor::~Cursor() {}
+
+bool Cursor::feed(std::string_view str) {
+  for (auto c : str) {
+    if (!feed(c)) {
+      return false;
+    }
+  }
+  return is_valid();
+}
+
+void Cursor::reset() {
+  cursor_ = dic_.cursor_root();
+}
+
+size_t Cursor::predict(const std::function<bool(uint32_t, const std::string &)> &f,
+                       size_t limit) const {
+  return dic_.cursor_predict(cursor_, f, limit);
+}
+
+} // cda_tries
@@ -0,0 +1,42 @@
+#ifndef CDA_TRIES_CURSOR_HPP
+#define CDA_TRIES_CURSOR_HPP
+
+#include "DaTrieDic.hpp"
+
+namespace cda_tries {
+
+// Incremental traversal of a DaTrieDic, which is fed one byte at a time and
+// costs one transition per byte. A copy keeps its own position, so it can be
+// kept to go back to a previous prefix.
+class Cursor {
+public:
+  explicit Cursor(const DaTrieDic &dic);
+  ~Cursor();
+
+  // Moves by c, and returns false if no key starts with the bytes fed, after
+  // which the cursor stays invalid until reset.
+  bool feed(char c) { return dic_.cursor_feed(cursor_, c); }
+  bool feed(std::string_view str);
+  // Goes back to the root.
+  void reset();
+
+  // Returns true if a key starts with the bytes fed.
+  bool is_valid() const { return cursor_.node_pos != NOT_FOUND; }
+  // Returns true if the bytes fed form a key.
+  bool is_terminal() const { return id() != NOT_FOUND; }
+  // Returns the ID of the key of the bytes fed, or NOT_FOUND.
+  uint32_t id() const { return dic_.cursor_id(cursor_); }
+  // Calls f(str_id, str) for each key starting with the bytes fed in
+  // lexicographical order, until f returns false or limit keys are reported.
+  // Returns the number of the reported keys.
+  size_t predict(const std::function<bool(uint32_t, const std::string &)> &f,
+                 size_t limit = SIZE_MAX) const;
+
+private:
+  const DaTrieDic &dic_;
+  cursor_t cursor_;
+};
+
+} // cda_tries
+
+#endif // CDA_TRIES_CURSOR_HPP
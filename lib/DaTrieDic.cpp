@@ -1,163 +1,281 @@
-#include <algorithm>
+#include <iostream>
 
-#include "Builder.hpp"
 #include "DaTrieDic.hpp"
 
 namespace cda_tries {
 
-DaTrieDic::DaTrieDic() {}
+DaTrieDic::DaTrieDic() : dic_(TrieDic::create(bc_type::PLAIN)) {}
 
 DaTrieDic::~DaTrieDic() {}
 
-void DaTrieDic::build(const std::vector<std::string> &strs, bc_type type) {
+void DaTrieDic::build(const std::vector<std::string> &strs, bc_type type, id_order order,
+                      const fold_map_t &fold_map) {
   clear();
-  if (strs.empty()) {
-    return;
-  }
+  dic_ = TrieDic::create(type);
+  dic_->build(strs, order, fold_map);
+}
 
-  num_strs_ = strs.size();
-  max_length_ = table_.build(strs);
+uint32_t DaTrieDic::lookup(const char *str) const {
+  return dic_->lookup(str);
+}
 
-  Builder builder(strs, table_);
-  builder.build_(type);
+uint32_t DaTrieDic::lookup(const char *str, size_t length) const {
+  return dic_->lookup(str, length);
+}
 
-  bc_ = Bc::create(type);
-  bc_->build(builder.bc_);
-  term_flags_.build(builder.term_flags_);
-  tail_.build(builder.tail_);
+void DaTrieDic::lookup_batch(const char *const *strs, size_t size, uint32_t *ids) const {
+  dic_->lookup_batch(strs, size, ids);
 }
 
-uint32_t DaTrieDic::lookup(const char *str) const {
-  uint32_t node_pos = 0;
-
-  while (!bc_->is_leaf(node_pos)) {
-    if (*str == '\0') {
-      return term_flags_[node_pos] ? to_str_id_(node_pos) : NOT_FOUND;
-    }
-    auto label = static_cast<uint8_t>(*str++);
-    auto child_pos = bc_->base(node_pos) ^ table_.code(label);
-    if (child_pos == 0 || bc_->check(child_pos) != node_pos) {
-      return NOT_FOUND;
-    }
-    node_pos = child_pos;
-  }
+void DaTrieDic::lookup_batch(const std::string_view *strs, size_t size, uint32_t *ids) const {
+  dic_->lookup_batch(strs, size, ids);
+}
 
-  auto tail = &tail_[bc_->link(node_pos)];
-  while (*tail != '\0' && *tail == *str) {
-    ++tail;
-    ++str;
-  }
-  return (*tail == *str) ? to_str_id_(node_pos) : NOT_FOUND;
+void DaTrieDic::lookup_sorted_batch(const char *const *strs, size_t size,
+                                    uint32_t *ids) const {
+  dic_->lookup_sorted_batch(strs, size, ids);
+}
+
+void DaTrieDic::lookup_sorted_batch(const std::string_view *strs, size_t size,
+                                    uint32_t *ids) const {
+  dic_->lookup_sorted_batch(strs, size, ids);
+}
+
+void DaTrieDic::common_prefix_search(const char *text, size_t length,
+                                     std::vector<match_t> &ret) const {
+  dic_->common_prefix_search(text, length, ret);
+}
+
+size_t DaTrieDic::predictive_search(
+  std::string_view prefix, const std::function<bool(uint32_t, const std::string &)> &f,
+  size_t limit) const {
+  return dic_->predictive_search(prefix, f, limit);
+}
+
+size_t DaTrieDic::fuzzy_search(
+  std::string_view query, size_t max_distance,
+  const std::function<bool(uint32_t, const std::string &, size_t)> &f, size_t limit) const {
+  return dic_->fuzzy_search(query, max_distance, f, limit);
+}
+
+size_t DaTrieDic::pattern_search(
+  const Pattern &pattern, const std::function<bool(uint32_t, const std::string &)> &f,
+  size_t limit) const {
+  return dic_->pattern_search(pattern, f, limit);
+}
+
+uint32_t DaTrieDic::lower_bound(std::string_view key) const {
+  return dic_->lower_bound(key);
+}
+
+uint32_t DaTrieDic::upper_bound(std::string_view key) const {
+  return dic_->upper_bound(key);
+}
+
+size_t DaTrieDic::range(std::string_view lo, std::string_view hi,
+                        const std::function<bool(uint32_t, const std::string &)> &f,
+                        size_t limit) const {
+  return dic_->range(lo, hi, f, limit);
+}
+
+size_t DaTrieDic::count_prefix(std::string_view prefix) const {
+  return dic_->count_prefix(prefix);
+}
+
+void DaTrieDic::build_count_index() {
+  dic_->build_count_index();
+}
+
+void DaTrieDic::build_child_index() {
+  dic_->build_child_index();
+}
+
+void DaTrieDic::build_weights(const std::vector<uint32_t> &weights) {
+  dic_->build_weights(weights);
+}
+
+void DaTrieDic::topk_completions(std::string_view prefix, size_t k,
+                                 std::vector<weighted_t> &ret) const {
+  dic_->topk_completions(prefix, k, ret);
+}
+
+void DaTrieDic::build_scanner() {
+  dic_->build_scanner();
+}
+
+void DaTrieDic::scan(std::string_view text,
+                     const std::function<void(const match_t &)> &f) const {
+  dic_->scan(text, f);
+}
+
+cursor_t DaTrieDic::cursor_root() const {
+  return dic_->cursor_root();
+}
+
+bool DaTrieDic::cursor_feed(cursor_t &cursor, char c) const {
+  return dic_->cursor_feed(cursor, c);
+}
+
+uint32_t DaTrieDic::cursor_id(const cursor_t &cursor) const {
+  return dic_->cursor_id(cursor);
+}
+
+size_t DaTrieDic::cursor_predict(const cursor_t &cursor,
+                                 const std::function<bool(uint32_t, const std::string &)> &f,
+                                 size_t limit) const {
+  return dic_->cursor_predict(cursor, f, limit);
+}
+
+match_t DaTrieDic::longest_prefix_match(const char *str, size_t length) const {
+  return dic_->longest_prefix_match(str, length);
+}
+
+void DaTrieDic::longest_prefix_match_batch(const char *const *strs, const size_t *lengths,
+                                           size_t size, match_t *ret) const {
+  dic_->longest_prefix_match_batch(strs, lengths, size, ret);
 }
 
 void DaTrieDic::access(uint32_t str_id, std::string &ret) const {
-  ret.clear();
-  if (num_strs_ <= str_id) {
-    return;
+  dic_->access(str_id, ret);
+}
+
+void DaTrieDic::access_batch(const uint32_t *str_ids, size_t size, std::string &bytes,
+                             std::vector<size_t> &offsets) const {
+  dic_->access_batch(str_ids, size, bytes, offsets);
+}
+
+size_t DaTrieDic::access(uint32_t str_id, char *buf, size_t capacity) const {
+  return dic_->access(str_id, buf, capacity);
+}
+
+std::string_view DaTrieDic::access(uint32_t str_id) const {
+  return dic_->access(str_id);
+}
+
+void DaTrieDic::enumerate(std::vector<uint32_t> &ret) const {
+  dic_->enumerate(ret);
+}
+
+size_t DaTrieDic::enumerate(const std::function<bool(uint32_t, const std::string &)> &f) const {
+  return dic_->enumerate(f);
+}
+
+size_t DaTrieDic::enumerate(uint32_t &node_pos, size_t size,
+                            const std::function<bool(uint32_t, const std::string &)> &f) const {
+  return dic_->enumerate(node_pos, size, f);
+}
+
+void DaTrieDic::intersect(const DaTrieDic &other,
+                          const std::function<void(uint32_t, uint32_t)> &f) const {
+  dic_->intersect(*other.dic_, f);
+}
+
+void DaTrieDic::difference(const DaTrieDic &other,
+                           const std::function<void(uint32_t)> &f) const {
+  dic_->difference(*other.dic_, f);
+}
+
+void DaTrieDic::merge(const DaTrieDic &other,
+                      const std::function<void(uint32_t, uint32_t)> &f) const {
+  dic_->merge(*other.dic_, f);
+}
+
+void DaTrieDic::set_values(const std::vector<uint32_t> &values) {
+  if (values.size() != num_strs()) {
+    std::cerr << "Critical error: the number of values differs from num_strs" << std::endl;
+    exit(1);
+  }
+  values_.build(values);
+}
+
+void DaTrieDic::set_blobs(const std::vector<std::string> &blobs) {
+  if (blobs.size() != num_strs()) {
+    std::cerr << "Critical error: the number of blobs differs from num_strs" << std::endl;
+    exit(1);
   }
-  ret.reserve(max_length_);
+  blobs_.build(blobs);
+}
+
+uint32_t DaTrieDic::value(uint32_t str_id) const {
+  return (str_id < values_.size()) ? values_[str_id] : NOT_FOUND;
+}
 
-  auto node_pos = to_node_pos_(str_id);
-  auto tail_pos = bc_->is_leaf(node_pos) ? bc_->link(node_pos) : 0;
+std::string_view DaTrieDic::blob(uint32_t str_id) const {
+  return (str_id < blobs_.size()) ? blobs_[str_id] : std::string_view();
+}
 
-  while (node_pos != 0) {
-    auto parent_pos = bc_->check(node_pos);
-    auto code = static_cast<uint8_t>(bc_->base(parent_pos) ^ node_pos);
-    ret += table_.label(code);
-    node_pos = parent_pos;
+uint32_t DaTrieDic::lookup_value(std::string_view str, uint32_t &value) const {
+  if (values_.size() == 0) {
+    return NOT_FOUND;
+  }
+  auto str_id = dic_->lookup(str.data(), str.size());
+  if (str_id != NOT_FOUND) {
+    value = values_[str_id];
   }
+  return str_id;
+}
 
-  std::reverse(ret.begin(), ret.end());
-  ret += &tail_[tail_pos];
+uint32_t DaTrieDic::lookup_value(std::string_view str, std::string_view &blob) const {
+  if (blobs_.size() == 0) {
+    return NOT_FOUND;
+  }
+  auto str_id = dic_->lookup(str.data(), str.size());
+  if (str_id != NOT_FOUND) {
+    blob = blobs_[str_id];
+  }
+  return str_id;
 }
 
-void DaTrieDic::enumerate(std::vector<uint32_t> &ret) const {
-  ret.clear();
-  ret.reserve(num_strs_);
-  enumerate_(0, ret);
+bc_type DaTrieDic::type() const {
+  return dic_->type();
+}
+
+id_order DaTrieDic::order() const {
+  return dic_->order();
 }
 
 size_t DaTrieDic::num_strs() const {
-  return num_strs_;
+  return dic_->num_strs();
 }
 
 size_t DaTrieDic::max_length() const {
-  return max_length_;
+  return dic_->max_length();
 }
 
 size_t DaTrieDic::bc_size() const {
-  return bc_ ? bc_->size() : 0;
+  return dic_->bc_size();
 }
 
 size_t DaTrieDic::tail_size() const {
-  return tail_.size();
+  return dic_->tail_size();
 }
 
 size_t DaTrieDic::size_in_bytes() const {
-  size_t size = 0;
-  size += bc_ ? bc_->size_in_bytes() : 0;
-  size += term_flags_.size_in_bytes();
-  size += tail_.size_in_bytes();
-  size += table_.size_in_bytes();
-  return size;
+  return dic_->size_in_bytes() + values_.size_in_bytes() + blobs_.size_in_bytes();
 }
 
 void DaTrieDic::stat(std::ostream &os) const {
-  os << "Double-array trie dictionary stat..." << std::endl;
-  os << "num strs     : " << num_strs() << std::endl;
-  os << "bc size      : " << bc_size() << std::endl;
-  os << "tail size    : " << tail_size() << std::endl;
-  os << "size in bytes: " << size_in_bytes() << std::endl;
-  bc_->stat(os);
+  dic_->stat(os);
 }
 
 void DaTrieDic::write(std::ostream &os) const {
-  bc_->write(os);
-  term_flags_.write(os);
-  tail_.write(os);
-  table_.write(os);
-  os.write(reinterpret_cast<const char *>(&num_strs_), sizeof(num_strs_));
-  os.write(reinterpret_cast<const char *>(&max_length_), sizeof(max_length_));
+  dic_->write(os);
+  values_.write(os);
+  blobs_.write(os);
 }
 
 void DaTrieDic::read(std::istream &is, bc_type type) {
   clear();
-  bc_ = Bc::create(type);
-  bc_->read(is);
-  term_flags_.read(is);
-  tail_.read(is);
-  table_.read(is);
-  is.read(reinterpret_cast<char *>(&num_strs_), sizeof(num_strs_));
-  is.read(reinterpret_cast<char *>(&max_length_), sizeof(max_length_));
+  dic_ = TrieDic::create(type);
+  dic_->read(is);
+  values_.read(is);
+  blobs_.read(is);
 }
 
 void DaTrieDic::clear() {
-  bc_.reset();
-  term_flags_.clear();
-  tail_.clear();
-  table_.clear();
-  num_strs_   = 0;
-  max_length_ = 0;
-}
-
-void DaTrieDic::enumerate_(uint32_t node_pos, std::vector<uint32_t> &ret) const {
-  if (term_flags_[node_pos]) {
-    ret.push_back(to_str_id_(node_pos));
-  }
-  if (bc_->is_leaf(node_pos)) {
-    return;
-  }
-
-  auto base = bc_->base(node_pos);
-  for (uint8_t label = 0;; ++label) {
-    auto child_pos = base ^ table_.code(label);
-    if (child_pos != 0 && bc_->check(child_pos) == node_pos) {
-      enumerate_(child_pos, ret);
-    }
-    if (label == UINT8_MAX) {
-      break;
-    }
-  }
+  dic_->clear();
+  values_.clear();
+  blobs_.clear();
 }
 
 } // cda_tries
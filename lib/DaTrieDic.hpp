@@ -1,27 +1,179 @@
 #ifndef CDA_TRIES_DA_TRIE_DIC_HPP
 #define CDA_TRIES_DA_TRIE_DIC_HPP
 
-#include "Bc.hpp"
-#include "BitArray.hpp"
-#include "CodeTable.hpp"
+#include "BlobArray.hpp"
+#include "TrieDic.hpp"
 
 namespace cda_tries {
 
+// Wrapper of BasicDaTrieDic whose representation type is given at runtime.
+// Use BasicDaTrieDic directly if the type is known at compile time.
 class DaTrieDic {
 public:
   DaTrieDic();
   ~DaTrieDic();
 
-  // Builds a dictinoary from sorted strs in lexicographical order.
-  void build(const std::vector<std::string> &strs, bc_type type);
+  // Builds a dictinoary from sorted strs in lexicographical order. If order
+  // is id_order::LEX, the ID of strs[i] is i, so that the keys starting with
+  // a prefix have consecutive IDs.
+  //
+  // If fold_map is not the identity, e.g., AsciiCaseFoldMap(), the keys are
+  // stored with their labels folded, where the keys that become equal are
+  // merged, and IDs follow the folded keys. Queries are then matched through
+  // fold_map, and the strings are returned in the folded form.
+  void build(const std::vector<std::string> &strs, bc_type type,
+             id_order order = id_order::PLACEMENT,
+             const fold_map_t &fold_map = IdentityFoldMap());
 
   // Retruns the ID if str is in the dictionary, otherwise NOT_FOUND.
   uint32_t lookup(const char *str) const;
+  // Same as lookup for str[0,length), which needs no terminator.
+  uint32_t lookup(const char *str, size_t length) const;
+  uint32_t lookup(std::string_view str) const {
+    return lookup(str.data(), str.size());
+  }
+  // Looks up strs[0,size) into ids[0,size) with overlapped cache misses.
+  void lookup_batch(const char *const *strs, size_t size, uint32_t *ids) const;
+  void lookup_batch(const std::string_view *strs, size_t size, uint32_t *ids) const;
+  // Looks up strs[0,size) into ids[0,size), resuming each descent from the
+  // node of the longest common prefix with the previous string. Any order
+  // is correct, but sorted strs share the most.
+  void lookup_sorted_batch(const char *const *strs, size_t size, uint32_t *ids) const;
+  void lookup_sorted_batch(const std::string_view *strs, size_t size, uint32_t *ids) const;
+  // Returns the keys that are prefixes of text[0,length), in increasing
+  // order of length, by one traversal.
+  void common_prefix_search(const char *text, size_t length, std::vector<match_t> &ret) const;
+  void common_prefix_search(std::string_view text, std::vector<match_t> &ret) const {
+    common_prefix_search(text.data(), text.size(), ret);
+  }
+  // Calls f(str_id, str) for each key str starting with prefix, in
+  // lexicographical order, until f returns false or limit keys are reported.
+  // Returns the number of the reported keys.
+  size_t predictive_search(std::string_view prefix,
+                           const std::function<bool(uint32_t, const std::string &)> &f,
+                           size_t limit = SIZE_MAX) const;
+  // Calls f(str_id, str, distance) for each key str within Levenshtein
+  // distance max_distance of query, in lexicographical order, until f returns
+  // false or limit keys are reported. Returns the number of the reported keys.
+  size_t fuzzy_search(std::string_view query, size_t max_distance,
+                      const std::function<bool(uint32_t, const std::string &, size_t)> &f,
+                      size_t limit = SIZE_MAX) const;
+  // Calls f(str_id, str) for each key str matched by pattern, in
+  // lexicographical order, until f returns false or limit keys are reported.
+  // Returns the number of the reported keys. If the dictionary is built with
+  // fold_map, pattern must be built with the same one to match as the other
+  // queries do.
+  size_t pattern_search(const Pattern &pattern,
+                        const std::function<bool(uint32_t, const std::string &)> &f,
+                        size_t limit = SIZE_MAX) const;
+  // Returns the ID of the smallest key not less than key, or NOT_FOUND.
+  uint32_t lower_bound(std::string_view key) const;
+  // Returns the ID of the smallest key greater than key, or NOT_FOUND.
+  uint32_t upper_bound(std::string_view key) const;
+  // Calls f(str_id, str) for each key str in [lo,hi) in lexicographical
+  // order, until f returns false or limit keys are reported. Returns the
+  // number of the reported keys.
+  size_t range(std::string_view lo, std::string_view hi,
+               const std::function<bool(uint32_t, const std::string &)> &f,
+               size_t limit = SIZE_MAX) const;
+  // Returns the number of the keys starting with prefix. It takes
+  // O(|prefix|) time after build_count_index, otherwise it traverses the
+  // subtree of prefix.
+  size_t count_prefix(std::string_view prefix) const;
+  // Stores the number of the keys in the subtree of each internal node, in
+  // the bits of num_strs per node.
+  void build_count_index();
+  // Stores the labels of the first child and the next sibling of each node,
+  // in two bytes per element, so that traversals visit only the children.
+  void build_child_index();
+  // Attaches weights[str_id] to the string with str_id, where weights.size()
+  // is num_strs, and stores the maximum weight in the subtree of each
+  // internal node for topk_completions.
+  void build_weights(const std::vector<uint32_t> &weights);
+  // Returns up to k keys starting with prefix in decreasing order of weight,
+  // visiting O(k*depth) nodes by best-first search. Returns nothing unless
+  // build_weights has been called.
+  void topk_completions(std::string_view prefix, size_t k, std::vector<weighted_t> &ret) const;
+  // Stores the failure and output links of the Aho-Corasick automaton over
+  // the nodes and the bytes in the tails for scan.
+  void build_scanner();
+  // Calls f(match_t{str_id, end}) for each occurrence of a key ending at
+  // text[end-1]. It takes linear time in the text length and the occurrences
+  // after build_scanner, otherwise it runs common_prefix_search at every
+  // offset. The empty key ends at every offset in [0,text.size()].
+  void scan(std::string_view text, const std::function<void(const match_t &)> &f) const;
+  // Primitives of Cursor. cursor_feed moves cursor by one transition and
+  // returns false if no key starts with the bytes fed.
+  cursor_t cursor_root() const;
+  bool cursor_feed(cursor_t &cursor, char c) const;
+  uint32_t cursor_id(const cursor_t &cursor) const;
+  size_t cursor_predict(const cursor_t &cursor,
+                        const std::function<bool(uint32_t, const std::string &)> &f,
+                        size_t limit = SIZE_MAX) const;
+  // Returns the longest key that is a prefix of str[0,length), or
+  // match_t{NOT_FOUND, 0} if no key is.
+  match_t longest_prefix_match(const char *str, size_t length) const;
+  match_t longest_prefix_match(std::string_view str) const {
+    return longest_prefix_match(str.data(), str.size());
+  }
+  // Runs longest_prefix_match for strs[i][0,lengths[i]) into ret[i] for
+  // i in [0,size) with overlapped cache misses.
+  void longest_prefix_match_batch(const char *const *strs, const size_t *lengths,
+                                  size_t size, match_t *ret) const;
   // Returns the string with str_id in [0,num_strs).
   void access(uint32_t str_id, std::string &ret) const;
+  // Writes the string with str_id into buf without the terminator, and
+  // returns its length. If the length exceeds capacity, buf does not hold
+  // the string and may be partially overwritten.
+  size_t access(uint32_t str_id, char *buf, size_t capacity) const;
+  // Returns the string with str_id in a thread-local buffer, which is valid
+  // until the next call on the same thread.
+  std::string_view access(uint32_t str_id) const;
+  // Writes the strings with str_ids[0,size) into bytes, where the i-th one
+  // is bytes[offsets[i],offsets[i+1]). The path shared with the previous
+  // string is copied instead of decoded, so IDs in key order share the most.
+  void access_batch(const uint32_t *str_ids, size_t size, std::string &bytes,
+                    std::vector<size_t> &offsets) const;
   // Returns all stored strings in lexicographical order.
   void enumerate(std::vector<uint32_t> &ret) const;
-
+  // Calls f(str_id, str) for all stored strings in lexicographical order,
+  // until f returns false. Returns the number of the reported strings.
+  size_t enumerate(const std::function<bool(uint32_t, const std::string &)> &f) const;
+  // Calls f(str_id, str) for up to size keys in lexicographical order from
+  // the node of node_pos, which is 0 at first and is updated to the next
+  // node to visit, or NOT_FOUND at the end. It backs Enumerator.
+  size_t enumerate(uint32_t &node_pos, size_t size,
+                   const std::function<bool(uint32_t, const std::string &)> &f) const;
+
+  // Calls f(str_id, other_id) for each key in both this and other, in
+  // lexicographical order. The tries are traversed in parallel, descending
+  // only into the labels on both sides.
+  void intersect(const DaTrieDic &other, const std::function<void(uint32_t, uint32_t)> &f) const;
+  // Calls f(str_id) for each key in this but not in other, in
+  // lexicographical order.
+  void difference(const DaTrieDic &other, const std::function<void(uint32_t)> &f) const;
+  // Calls f(str_id, other_id) for each key in this or other, in
+  // lexicographical order, where the ID on the side without the key is
+  // NOT_FOUND.
+  void merge(const DaTrieDic &other, const std::function<void(uint32_t, uint32_t)> &f) const;
+
+  // Attaches values[str_id] to the string with str_id, where values.size()
+  // must be num_strs. The values are packed in the bits of the maximum.
+  void set_values(const std::vector<uint32_t> &values);
+  // Attaches the byte string blobs[str_id] to the string with str_id, where
+  // blobs.size() must be num_strs.
+  void set_blobs(const std::vector<std::string> &blobs);
+  // Returns the value attached to str_id, or NOT_FOUND if there is none.
+  uint32_t value(uint32_t str_id) const;
+  // Returns the blob attached to str_id, or an empty one if there is none.
+  std::string_view blob(uint32_t str_id) const;
+  // Retruns the ID if str is in the dictionary and sets the attached value,
+  // otherwise returns NOT_FOUND, as well as if no values are attached.
+  uint32_t lookup_value(std::string_view str, uint32_t &value) const;
+  uint32_t lookup_value(std::string_view str, std::string_view &blob) const;
+
+  bc_type type() const;
+  id_order order() const;
   size_t num_strs() const;
   size_t max_length() const;
 
@@ -40,22 +192,9 @@ public:
   DaTrieDic &operator=(const DaTrieDic &) = delete;
 
 private:
-  std::unique_ptr<Bc> bc_;
-  BitArray term_flags_;
-  Array<char> tail_;
-  CodeTable table_;
-
-  size_t num_strs_   = 0;
-  size_t max_length_ = 0;
-
-  uint32_t to_str_id_(uint32_t node_pos) const {
-    return term_flags_.rank(node_pos);
-  };
-  uint32_t to_node_pos_(uint32_t str_id) const {
-    return term_flags_.select(str_id);
-  };
-
-  void enumerate_(uint32_t node_pos, std::vector<uint32_t> &ret) const;
+  std::unique_ptr<TrieDic> dic_;
+  SmallArray values_;
+  BlobArray blobs_;
 };
 
 } // cda_tries
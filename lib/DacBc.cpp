@@ -143,20 +143,6 @@ void DacBc::clear() {
   num_emps_ = 0;
 }
 
-uint32_t DacBc::access_(uint32_t pos) const {
-  uint32_t level = 0;
-  uint32_t value = values_[level][pos];
-  while (flags_[level][pos]) {
-    pos = flags_[level].rank(pos);
-    ++level;
-    value |= static_cast<uint32_t>(values_[level][pos]) << (level * 8);
-    if (level == max_level_) {
-      break;
-    }
-  }
-  return value;
-}
-
 size_t DacBc::dac_size_in_bytes_() const {
   size_t size = 0;
   for (uint32_t j = 0; j < max_level_; ++j) {
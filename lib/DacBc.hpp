@@ -7,8 +7,10 @@
 
 namespace cda_tries {
 
-class DacBc : public Bc {
+class DacBc final : public Bc {
 public:
+  static constexpr bc_type TYPE = bc_type::DAC;
+
   DacBc();
   ~DacBc();
 
@@ -29,6 +31,13 @@ public:
   bool is_fixed(uint32_t pos) const {
     return check(pos) != pos;
   }
+  void prefetch(uint32_t pos) const {
+    Prefetch(&values_[0][pos * 2]);
+    if (max_level_ != 0) {
+      flags_[0].prefetch(pos * 2);
+    }
+    leaf_flags_.prefetch(pos);
+  }
 
   size_t size() const;
   size_t size_in_bytes() const;
@@ -52,7 +61,17 @@ private:
   uint32_t max_level_ = 0;
   size_t num_emps_ = 0;
 
-  uint32_t access_(uint32_t pos) const;
+  uint32_t access_(uint32_t pos) const {
+    uint32_t level = 0;
+    uint32_t value = values_[level][pos];
+    // flags_[max_level_] is not built, e.g., flags_[0] if no value exceeds a byte.
+    while (level < max_level_ && flags_[level][pos]) {
+      pos = flags_[level].rank(pos);
+      ++level;
+      value |= static_cast<uint32_t>(values_[level][pos]) << (level * 8);
+    }
+    return value;
+  }
   size_t dac_size_in_bytes_() const;
 };
 
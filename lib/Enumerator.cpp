@@ -0,0 +1,46 @@
+#include <cstring>
+
+#include "Enumerator.hpp"
+
+namespace cda_tries {
+
+Enumerator::Enumerator(const DaTrieDic &dic) : dic_(dic) {
+  if (dic_.num_strs() == 0) {
+    node_pos_ = NOT_FOUND;
+  }
+}
+
+Enumerator::Enumerator(const DaTrieDic &dic, std::string_view token) : dic_(dic) {
+  if (token.size() != sizeof(node_pos_)) {
+    node_pos_ = NOT_FOUND;
+    return;
+  }
+  std::memcpy(&node_pos_, token.data(), sizeof(node_pos_));
+  // An invalid node_pos_ is set to NOT_FOUND without reporting keys.
+  dic_.enumerate(node_pos_, 0, [](uint32_t, const std::string &) {
+    return true;
+  });
+}
+
+Enumerator::~Enumerator() {}
+
+size_t Enumerator::next(size_t size, std::vector<uint32_t> &ret) {
+  return next(size, [&](uint32_t str_id, const std::string &) {
+    ret.push_back(str_id);
+    return true;
+  });
+}
+
+size_t Enumerator::next(size_t size,
+                        const std::function<bool(uint32_t, const std::string &)> &f) {
+  if (node_pos_ == NOT_FOUND || size == 0) {
+    return 0;
+  }
+  return dic_.enumerate(node_pos_, size, f);
+}
+
+std::string Enumerator::token() const {
+  return std::string(reinterpret_cast<const char *>(&node_pos_), sizeof(node_pos_));
+}
+
+} // cda_tries
@@ -0,0 +1,38 @@
+#ifndef CDA_TRIES_ENUMERATOR_HPP
+#define CDA_TRIES_ENUMERATOR_HPP
+
+#include "DaTrieDic.hpp"
+
+namespace cda_tries {
+
+// Resumable enumeration of the keys of a DaTrieDic in lexicographical order,
+// for paginated dumps. Its state is the next node to visit, whose path is
+// recovered by climbing the parents, so resuming from a token takes O(depth)
+// time and a page takes time proportional to its size.
+class Enumerator {
+public:
+  explicit Enumerator(const DaTrieDic &dic);
+  // Resumes from token, which is returned by token() for the same
+  // dictionary. The enumeration is at the end if token is invalid.
+  Enumerator(const DaTrieDic &dic, std::string_view token);
+  ~Enumerator();
+
+  // Appends the IDs of the next up to size keys to ret, and returns the
+  // number of them.
+  size_t next(size_t size, std::vector<uint32_t> &ret);
+  // Calls f(str_id, str) for the next up to size keys, until f returns
+  // false. Returns the number of the reported keys.
+  size_t next(size_t size, const std::function<bool(uint32_t, const std::string &)> &f);
+
+  bool is_end() const { return node_pos_ == NOT_FOUND; }
+  // Returns the opaque token to resume from the current state.
+  std::string token() const;
+
+private:
+  const DaTrieDic &dic_;
+  uint32_t node_pos_ = 0;
+};
+
+} // cda_tries
+
+#endif // CDA_TRIES_ENUMERATOR_HPP
@@ -149,20 +149,6 @@ void FastDacBc::clear() {
   num_emps_ = 0;
 }
 
-uint32_t FastDacBc::access_(uint32_t pos) const {
-  uint32_t value = values_1st_[pos] >> 1;
-  if ((values_1st_[pos] & 1U) == 0) {
-    return value;
-  }
-  pos = ranks_[0][pos / 128] + value;
-  value = values_2nd_[pos] >> 1;
-  if ((values_2nd_[pos] & 1U) == 0) {
-    return value;
-  }
-  pos = ranks_[1][pos / 32768] + value;
-  return values_3rd_[pos];
-}
-
 size_t FastDacBc::dac_size_in_bytes_() const {
   size_t size = 0;
   size += values_1st_.size_in_bytes();
@@ -7,8 +7,10 @@
 
 namespace cda_tries {
 
-class FastDacBc : public Bc {
+class FastDacBc final : public Bc {
 public:
+  static constexpr bc_type TYPE = bc_type::FDAC;
+
   FastDacBc();
   ~FastDacBc();
 
@@ -29,6 +31,11 @@ public:
   bool is_fixed(uint32_t pos) const {
     return check(pos) != pos;
   }
+  void prefetch(uint32_t pos) const {
+    Prefetch(&values_1st_[pos * 2]);
+    Prefetch(&ranks_[0][pos * 2 / 128]);
+    leaf_flags_.prefetch(pos);
+  }
 
   size_t size() const;
   size_t size_in_bytes() const;
@@ -53,7 +60,19 @@ private:
   SmallArray extras_;
   size_t num_emps_ = 0;
 
-  uint32_t access_(uint32_t pos) const;
+  uint32_t access_(uint32_t pos) const {
+    uint32_t value = values_1st_[pos] >> 1;
+    if ((values_1st_[pos] & 1U) == 0) {
+      return value;
+    }
+    pos = ranks_[0][pos / 128] + value;
+    value = values_2nd_[pos] >> 1;
+    if ((values_2nd_[pos] & 1U) == 0) {
+      return value;
+    }
+    pos = ranks_[1][pos / 32768] + value;
+    return values_3rd_[pos];
+  }
   size_t dac_size_in_bytes_() const;
 };
 
@@ -0,0 +1,363 @@
+#include <algorithm>
+#include <bitset>
+#include <map>
+
+#include "Pattern.hpp"
+
+namespace cda_tries {
+
+// Builds a Thompson NFA from a pattern and converts it into a DFA by the
+// subset construction.
+class PatternCompiler {
+public:
+  PatternCompiler(std::string_view pattern, const fold_map_t &fold_map)
+    : pattern_(pattern), fold_map_(fold_map) {}
+  ~PatternCompiler() {}
+
+  bool compile_glob(Pattern &ret) {
+    auto frag = empty_();
+    while (pos_ < pattern_.size()) {
+      auto c = pattern_[pos_++];
+      fragment_t next;
+      if (c == '?') {
+        next = set_(std::bitset<256>().set());
+      } else if (c == '*') {
+        next = star_(set_(std::bitset<256>().set()));
+      } else {
+        if (c == '\\') {
+          if (pos_ == pattern_.size()) {
+            return false;
+          }
+          c = pattern_[pos_++];
+        }
+        next = byte_(c);
+      }
+      frag = concat_(frag, next);
+    }
+    return determinize_(frag, ret);
+  }
+
+  bool compile_regex(Pattern &ret) {
+    fragment_t frag;
+    if (!parse_alt_(frag) || pos_ != pattern_.size()) {
+      return false;
+    }
+    return determinize_(frag, ret);
+  }
+
+  PatternCompiler(const PatternCompiler &) = delete;
+  PatternCompiler &operator=(const PatternCompiler &) = delete;
+
+private:
+  static constexpr uint32_t NONE = UINT32_MAX;
+
+  struct node_t {
+    std::bitset<256> labels; // labels of the transition to next
+    uint32_t next = NONE;
+    std::vector<uint32_t> eps;
+  };
+  struct fragment_t {
+    uint32_t begin;
+    uint32_t end;
+  };
+
+  std::string_view pattern_;
+  const fold_map_t &fold_map_;
+  size_t pos_ = 0;
+  std::vector<node_t> nodes_;
+
+  uint32_t node_() {
+    nodes_.emplace_back();
+    return static_cast<uint32_t>(nodes_.size() - 1);
+  }
+  fragment_t empty_() {
+    auto node = node_();
+    return fragment_t{node, node};
+  }
+  fragment_t set_(const std::bitset<256> &labels) {
+    auto begin = node_(), end = node_();
+    nodes_[begin].labels = labels;
+    nodes_[begin].next = end;
+    return fragment_t{begin, end};
+  }
+  fragment_t byte_(char c) {
+    return set_(std::bitset<256>().set(static_cast<uint8_t>(c)));
+  }
+  fragment_t concat_(fragment_t lhs, fragment_t rhs) {
+    nodes_[lhs.end].eps.push_back(rhs.begin);
+    return fragment_t{lhs.begin, rhs.end};
+  }
+  fragment_t alt_(fragment_t lhs, fragment_t rhs) {
+    auto begin = node_(), end = node_();
+    nodes_[begin].eps = {lhs.begin, rhs.begin};
+    nodes_[lhs.end].eps.push_back(end);
+    nodes_[rhs.end].eps.push_back(end);
+    return fragment_t{begin, end};
+  }
+  fragment_t star_(fragment_t frag) {
+    auto begin = node_(), end = node_();
+    nodes_[begin].eps = {frag.begin, end};
+    nodes_[frag.end].eps.push_back(frag.begin);
+    nodes_[frag.end].eps.push_back(end);
+    return fragment_t{begin, end};
+  }
+  fragment_t plus_(fragment_t frag) {
+    auto end = node_();
+    nodes_[frag.end].eps.push_back(frag.begin);
+    nodes_[frag.end].eps.push_back(end);
+    return fragment_t{frag.begin, end};
+  }
+  fragment_t question_(fragment_t frag) {
+    auto begin = node_();
+    nodes_[begin].eps = {frag.begin, frag.end};
+    return fragment_t{begin, frag.end};
+  }
+
+  bool parse_alt_(fragment_t &ret) {
+    if (!parse_concat_(ret)) {
+      return false;
+    }
+    while (pos_ < pattern_.size() && pattern_[pos_] == '|') {
+      ++pos_;
+      fragment_t rhs;
+      if (!parse_concat_(rhs)) {
+        return false;
+      }
+      ret = alt_(ret, rhs);
+    }
+    return true;
+  }
+
+  bool parse_concat_(fragment_t &ret) {
+    ret = empty_();
+    while (pos_ < pattern_.size() && pattern_[pos_] != '|' && pattern_[pos_] != ')') {
+      fragment_t frag;
+      if (!parse_atom_(frag)) {
+        return false;
+      }
+      while (pos_ < pattern_.size()) {
+        auto c = pattern_[pos_];
+        if (c == '*') {
+          frag = star_(frag);
+        } else if (c == '+') {
+          frag = plus_(frag);
+        } else if (c == '?') {
+          frag = question_(frag);
+        } else {
+          break;
+        }
+        ++pos_;
+      }
+      ret = concat_(ret, frag);
+    }
+    return true;
+  }
+
+  bool parse_atom_(fragment_t &ret) {
+    auto c = pattern_[pos_++];
+    switch (c) {
+      case '(':
+        if (!parse_alt_(ret) || pos_ == pattern_.size() || pattern_[pos_] != ')') {
+          return false;
+        }
+        ++pos_;
+        return true;
+      case '.':
+        ret = set_(std::bitset<256>().set());
+        return true;
+      case '[':
+        return parse_class_(ret);
+      case '*':
+      case '+':
+      case '?':
+        return false;
+      case '\\':
+        if (pos_ == pattern_.size()) {
+          return false;
+        }
+        c = pattern_[pos_++];
+        break;
+      default:
+        break;
+    }
+    ret = byte_(c);
+    return true;
+  }
+
+  // Parses a class after '['. A ']' just after '[' or '[^' is a literal.
+  bool parse_class_(fragment_t &ret) {
+    std::bitset<256> labels;
+    bool negated = pos_ < pattern_.size() && pattern_[pos_] == '^';
+    if (negated) {
+      ++pos_;
+    }
+
+    auto read_byte = [&](uint8_t &label) {
+      if (pos_ == pattern_.size()) {
+        return false;
+      }
+      if (pattern_[pos_] == '\\') {
+        if (++pos_ == pattern_.size()) {
+          return false;
+        }
+      }
+      label = static_cast<uint8_t>(pattern_[pos_++]);
+      return true;
+    };
+
+    bool first = true;
+    while (true) {
+      if (pos_ == pattern_.size()) {
+        return false;
+      }
+      if (pattern_[pos_] == ']' && !first) {
+        ++pos_;
+        break;
+      }
+      first = false;
+      uint8_t lo = 0, hi = 0;
+      if (!read_byte(lo)) {
+        return false;
+      }
+      hi = lo;
+      if (pos_ + 1 < pattern_.size() && pattern_[pos_] == '-' && pattern_[pos_ + 1] != ']') {
+        ++pos_;
+        if (!read_byte(hi) || hi < lo) {
+          return false;
+        }
+      }
+      for (uint32_t label = lo; label <= hi; ++label) {
+        labels.set(label);
+      }
+    }
+
+    ret = set_(negated ? ~labels : labels);
+    return true;
+  }
+
+  void close_(std::vector<uint32_t> &states) const {
+    std::vector<bool> visited(nodes_.size(), false);
+    std::vector<uint32_t> stack(states);
+    states.clear();
+    while (!stack.empty()) {
+      auto state = stack.back();
+      stack.pop_back();
+      if (visited[state]) {
+        continue;
+      }
+      visited[state] = true;
+      states.push_back(state);
+      for (auto next : nodes_[state].eps) {
+        stack.push_back(next);
+      }
+    }
+    std::sort(states.begin(), states.end());
+  }
+
+  // Extends the labels of each transition to those folded into the same
+  // representative.
+  void fold_labels_() {
+    for (auto &node : nodes_) {
+      std::bitset<256> folded;
+      for (uint32_t label = 0; label < 256; ++label) {
+        if (node.labels[label]) {
+          folded.set(fold_map_[label]);
+        }
+      }
+      for (uint32_t label = 0; label < 256; ++label) {
+        node.labels[label] = folded[fold_map_[label]];
+      }
+    }
+  }
+
+  bool determinize_(fragment_t frag, Pattern &ret) {
+    if (fold_map_ != IdentityFoldMap()) {
+      fold_labels_();
+    }
+
+    // DFA state 0 is DEAD, corresponding to the empty set of NFA states.
+    std::vector<std::vector<uint32_t>> subsets(1);
+    std::map<std::vector<uint32_t>, uint32_t> ids{{subsets[0], 0}};
+    std::vector<uint32_t> trans;
+
+    std::vector<uint32_t> start{frag.begin};
+    close_(start);
+    ids.emplace(start, 1);
+    subsets.push_back(start);
+
+    for (uint32_t state = 0; state < subsets.size(); ++state) {
+      trans.resize((state + 1) * 256, Pattern::DEAD);
+      for (uint32_t label = 0; label < 256; ++label) {
+        std::vector<uint32_t> next;
+        for (auto node : subsets[state]) {
+          if (nodes_[node].next != NONE && nodes_[node].labels[label]) {
+            next.push_back(nodes_[node].next);
+          }
+        }
+        close_(next);
+        auto it = ids.find(next);
+        if (it == ids.end()) {
+          if (subsets.size() == Pattern::MAX_STATES) {
+            return false;
+          }
+          it = ids.emplace(next, static_cast<uint32_t>(subsets.size())).first;
+          subsets.push_back(next);
+        }
+        trans[state * 256 + label] = it->second;
+      }
+    }
+
+    ret.trans_.build(trans);
+    ret.accepts_.reset(subsets.size(), 0);
+    for (uint32_t state = 0; state < subsets.size(); ++state) {
+      auto &subset = subsets[state];
+      ret.accepts_[state] = std::binary_search(subset.begin(), subset.end(), frag.end);
+    }
+    return true;
+  }
+};
+
+Pattern::Pattern() {}
+
+Pattern::~Pattern() {}
+
+bool Pattern::build_glob(std::string_view glob, const fold_map_t &fold_map) {
+  clear();
+  PatternCompiler compiler(glob, fold_map);
+  if (!compiler.compile_glob(*this)) {
+    clear();
+    return false;
+  }
+  return true;
+}
+
+bool Pattern::build_regex(std::string_view regex, const fold_map_t &fold_map) {
+  clear();
+  PatternCompiler compiler(regex, fold_map);
+  if (!compiler.compile_regex(*this)) {
+    clear();
+    return false;
+  }
+  return true;
+}
+
+bool Pattern::match(std::string_view str) const {
+  if (num_states() == 0) {
+    return false;
+  }
+  auto state = start();
+  for (auto c : str) {
+    state = next(state, static_cast<uint8_t>(c));
+    if (state == DEAD) {
+      return false;
+    }
+  }
+  return is_accepting(state);
+}
+
+void Pattern::clear() {
+  trans_.clear();
+  accepts_.clear();
+}
+
+} // cda_tries
@@ -0,0 +1,56 @@
+#ifndef CDA_TRIES_PATTERN_HPP
+#define CDA_TRIES_PATTERN_HPP
+
+#include "Array.hpp"
+#include "CodeTable.hpp"
+
+namespace cda_tries {
+
+// DFA over bytes compiled from a glob or a regular expression, which matches
+// the whole of a string. State DEAD rejects any continuation.
+//
+// Glob: '?' matches any byte, '*' matches any sequence, and '\' escapes.
+// Regex: literals, '.', classes such as [a-z] and [^0-9], grouping with
+// '(' and ')', alternation '|', the repetitions '*', '+' and '?', and '\'
+// escaping the next byte.
+//
+// If fold_map is given, each byte matches the bytes folded into the same
+// representative, e.g., 'A' matches 'a' under AsciiCaseFoldMap(). A pattern
+// for a dictionary built with fold_map must be built with the same one.
+class Pattern {
+public:
+  static constexpr uint32_t DEAD       = 0;
+  static constexpr uint32_t MAX_STATES = 1U << 12;
+
+  Pattern();
+  ~Pattern();
+
+  // Returns false if the pattern is malformed or its DFA has more than
+  // MAX_STATES states, in which case the pattern is cleared.
+  bool build_glob(std::string_view glob, const fold_map_t &fold_map = IdentityFoldMap());
+  bool build_regex(std::string_view regex, const fold_map_t &fold_map = IdentityFoldMap());
+
+  uint32_t start() const { return 1; }
+  uint32_t next(uint32_t state, uint8_t label) const {
+    return trans_[(state << 8) | label];
+  }
+  bool is_accepting(uint32_t state) const { return accepts_[state] != 0; }
+  bool match(std::string_view str) const;
+
+  size_t num_states() const { return accepts_.size(); }
+
+  void clear();
+
+  Pattern(const Pattern &) = delete;
+  Pattern &operator=(const Pattern &) = delete;
+
+private:
+  Array<uint32_t> trans_;
+  Array<uint8_t> accepts_;
+
+  friend class PatternCompiler;
+};
+
+} // cda_tries
+
+#endif // CDA_TRIES_PATTERN_HPP
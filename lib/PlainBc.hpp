@@ -6,8 +6,10 @@
 
 namespace cda_tries {
 
-class PlainBc : public Bc {
+class PlainBc final : public Bc {
 public:
+  static constexpr bc_type TYPE = bc_type::PLAIN;
+
   PlainBc() {}
   ~PlainBc() {}
 
@@ -28,6 +30,9 @@ public:
   bool is_fixed(uint32_t pos) const {
     return bc_[pos].is_fixed();
   }
+  void prefetch(uint32_t pos) const {
+    Prefetch(&bc_[pos]);
+  }
 
   size_t size() const;;
   size_t size_in_bytes() const;
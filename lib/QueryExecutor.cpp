@@ -0,0 +1,164 @@
+#include <algorithm>
+
+#include "QueryExecutor.hpp"
+
+namespace cda_tries {
+
+QueryExecutor::QueryExecutor(size_t num_threads) : num_threads_(num_threads) {
+  if (num_threads_ == 0) {
+    num_threads_ = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+  }
+  threads_.reserve(num_threads_ - 1);
+  for (size_t i = 1; i < num_threads_; ++i) {
+    threads_.emplace_back(&QueryExecutor::loop_, this, i);
+  }
+}
+
+QueryExecutor::~QueryExecutor() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  start_cv_.notify_all();
+  for (auto &thread : threads_) {
+    thread.join();
+  }
+}
+
+void QueryExecutor::lookup_batch(const DaTrieDic &dic, const std::string_view *strs,
+                                 size_t size, uint32_t *ids) {
+  run(size, [&](size_t begin, size_t end) {
+    dic.lookup_batch(strs + begin, end - begin, ids + begin);
+  });
+}
+
+void QueryExecutor::access_batch(const DaTrieDic &dic, const uint32_t *ids, size_t size,
+                                 std::string *strs) {
+  run(size, [&](size_t begin, size_t end) {
+    for (auto i = begin; i < end; ++i) {
+      dic.access(ids[i], strs[i]);
+    }
+  });
+}
+
+void QueryExecutor::longest_prefix_match_batch(const DaTrieDic &dic,
+                                               const std::string_view *strs, size_t size,
+                                               match_t *ret) {
+  run(size, [&](size_t begin, size_t end) {
+    const char *ptrs[CHUNK_SIZE];
+    size_t lengths[CHUNK_SIZE];
+    for (; begin < end; begin += CHUNK_SIZE) {
+      auto num_strs = std::min(end - begin, CHUNK_SIZE);
+      for (size_t i = 0; i < num_strs; ++i) {
+        ptrs[i] = strs[begin + i].data();
+        lengths[i] = strs[begin + i].size();
+      }
+      dic.longest_prefix_match_batch(ptrs, lengths, num_strs, ret + begin);
+    }
+  });
+}
+
+void QueryExecutor::run(size_t size, const std::function<void(size_t, size_t)> &f) {
+  if (size == 0) {
+    return;
+  }
+  if (num_threads_ == 1 || size <= CHUNK_SIZE) {
+    f(0, size);
+    return;
+  }
+
+  std::unique_ptr<range_t[]> ranges(new range_t[num_threads_]);
+  for (size_t i = 0; i < num_threads_; ++i) {
+    ranges[i].begin = size * i / num_threads_;
+    ranges[i].end = size * (i + 1) / num_threads_;
+  }
+  job_t job{&f, ranges.get()};
+
+  std::lock_guard<std::mutex> run_lock(run_mutex_);
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    job_ = job;
+    ++generation_;
+    num_running_ = num_threads_ - 1;
+  }
+  start_cv_.notify_all();
+
+  work_(0, job);
+
+  std::unique_lock<std::mutex> lock(mutex_);
+  done_cv_.wait(lock, [this]() { return num_running_ == 0; });
+  job_ = job_t();
+}
+
+void QueryExecutor::loop_(size_t thread_pos) {
+  size_t generation = 0;
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true) {
+    start_cv_.wait(lock, [&]() { return stop_ || generation != generation_; });
+    if (stop_) {
+      return;
+    }
+    generation = generation_;
+    auto job = job_;
+
+    lock.unlock();
+    work_(thread_pos, job);
+    lock.lock();
+
+    if (--num_running_ == 0) {
+      done_cv_.notify_one();
+    }
+  }
+}
+
+// Processes the own range chunk by chunk, and then steals from the others
+// until no range is left.
+void QueryExecutor::work_(size_t thread_pos, const job_t &job) {
+  auto &range = job.ranges[thread_pos];
+  while (true) {
+    size_t begin = 0, end = 0;
+    while (pop_(range, begin, end)) {
+      (*job.f)(begin, end);
+    }
+    bool stolen = false;
+    for (size_t i = 1; i < num_threads_ && !stolen; ++i) {
+      stolen = steal_(range, job.ranges[(thread_pos + i) % num_threads_]);
+    }
+    if (!stolen) {
+      return;
+    }
+  }
+}
+
+bool QueryExecutor::pop_(range_t &range, size_t &begin, size_t &end) {
+  std::lock_guard<std::mutex> lock(range.mutex);
+  if (range.begin == range.end) {
+    return false;
+  }
+  begin = range.begin;
+  end = std::min(range.begin + CHUNK_SIZE, range.end);
+  range.begin = end;
+  return true;
+}
+
+// Moves the latter half of the victim's range, or all of it if it is at most
+// CHUNK_SIZE, into the empty range of the thief.
+bool QueryExecutor::steal_(range_t &range, range_t &victim) {
+  size_t begin = 0, end = 0;
+  {
+    std::lock_guard<std::mutex> lock(victim.mutex);
+    auto remaining = victim.end - victim.begin;
+    if (remaining == 0) {
+      return false;
+    }
+    begin = victim.end - (remaining <= CHUNK_SIZE ? remaining : remaining / 2);
+    end = victim.end;
+    victim.end = begin;
+  }
+  std::lock_guard<std::mutex> lock(range.mutex);
+  range.begin = begin;
+  range.end = end;
+  return true;
+}
+
+} // cda_tries
@@ -0,0 +1,77 @@
+#ifndef CDA_TRIES_QUERY_EXECUTOR_HPP
+#define CDA_TRIES_QUERY_EXECUTOR_HPP
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#include "DaTrieDic.hpp"
+
+namespace cda_tries {
+
+// Runs large batches of queries against a shared dictionary on a pool of
+// threads. A batch is split into a range per thread, each thread takes
+// CHUNK_SIZE queries at a time from the front of its own range, and an idle
+// thread steals the latter half of another range. The calling thread works
+// as one of the threads, and the results are written in place.
+class QueryExecutor {
+public:
+  static constexpr size_t CHUNK_SIZE = 256;
+
+  // Uses std::thread::hardware_concurrency() threads if num_threads is 0.
+  explicit QueryExecutor(size_t num_threads = 0);
+  ~QueryExecutor();
+
+  // Looks up strs[0,size) into ids[0,size).
+  void lookup_batch(const DaTrieDic &dic, const std::string_view *strs, size_t size,
+                    uint32_t *ids);
+  // Decodes the strings with ids[0,size) into strs[0,size).
+  void access_batch(const DaTrieDic &dic, const uint32_t *ids, size_t size,
+                    std::string *strs);
+  // Runs longest_prefix_match for strs[0,size) into ret[0,size).
+  void longest_prefix_match_batch(const DaTrieDic &dic, const std::string_view *strs,
+                                  size_t size, match_t *ret);
+  // Calls f(begin, end) for disjoint ranges covering [0,size) on the threads,
+  // and returns when all of them are finished. Concurrent calls are safe but
+  // take the threads one after another.
+  void run(size_t size, const std::function<void(size_t, size_t)> &f);
+
+  size_t num_threads() const { return num_threads_; }
+
+  QueryExecutor(const QueryExecutor &) = delete;
+  QueryExecutor &operator=(const QueryExecutor &) = delete;
+
+private:
+  struct range_t {
+    std::mutex mutex;
+    size_t begin = 0;
+    size_t end   = 0;
+  };
+
+  // Ranges of the threads and the function, which are local to a run call.
+  struct job_t {
+    const std::function<void(size_t, size_t)> *f = nullptr;
+    range_t *ranges = nullptr;
+  };
+
+  size_t num_threads_ = 0;
+  std::vector<std::thread> threads_;
+
+  std::mutex run_mutex_; // held during a run call
+  std::mutex mutex_;
+  std::condition_variable start_cv_;
+  std::condition_variable done_cv_;
+  job_t job_;
+  size_t generation_  = 0;
+  size_t num_running_ = 0;
+  bool stop_ = false;
+
+  void loop_(size_t thread_pos);
+  void work_(size_t thread_pos, const job_t &job);
+  bool pop_(range_t &range, size_t &begin, size_t &end);
+  bool steal_(range_t &range, range_t &victim);
+};
+
+} // cda_tries
+
+#endif // CDA_TRIES_QUERY_EXECUTOR_HPP
@@ -23,7 +23,7 @@ void SmallArray::build(const std::vector<uint32_t> &array) {
 
   size_ = array.size();
   chunks_.reset(size_ * bits_ / 32 + 1, 0);
-  mask_ = static_cast<uint32_t>((1 << bits_) - 1);
+  mask_ = (bits_ == 32) ? UINT32_MAX : (1U << bits_) - 1;
 
   for (uint32_t i = 0; i < size_; ++i) {
     auto chunk_pos = i * bits_ / 32;
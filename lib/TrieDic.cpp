@@ -0,0 +1,24 @@
+#include "BasicDaTrieDic.hpp"
+#include "TrieDic.hpp"
+
+namespace cda_tries {
+
+std::unique_ptr<TrieDic> TrieDic::create(bc_type type) {
+  std::unique_ptr<TrieDic> ret;
+  switch (type) {
+    case bc_type::PLAIN:
+      ret.reset(new BasicDaTrieDic<PlainBc>);
+      break;
+    case bc_type::DAC:
+      ret.reset(new BasicDaTrieDic<DacBc>);
+      break;
+    case bc_type::FDAC:
+      ret.reset(new BasicDaTrieDic<FastDacBc>);
+      break;
+  }
+  return ret;
+}
+
+TrieDic::~TrieDic() {}
+
+} // cda_tries
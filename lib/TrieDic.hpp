@@ -0,0 +1,98 @@
+#ifndef CDA_TRIES_TRIE_DIC_HPP
+#define CDA_TRIES_TRIE_DIC_HPP
+
+#include <functional>
+
+#include "Basic.hpp"
+#include "CodeTable.hpp"
+#include "Pattern.hpp"
+
+namespace cda_tries {
+
+// Interface of the dictionaries, each of which is implemented by
+// BasicDaTrieDic<BcT> for a concrete representation of BASE and CHECK.
+class TrieDic {
+public:
+  static std::unique_ptr<TrieDic> create(bc_type type);
+  virtual ~TrieDic();
+
+  virtual void build(const std::vector<std::string> &strs, id_order order,
+                     const fold_map_t &fold_map) = 0;
+
+  virtual uint32_t lookup(const char *str) const = 0;
+  virtual uint32_t lookup(const char *str, size_t length) const = 0;
+  virtual void lookup_batch(const char *const *strs, size_t size, uint32_t *ids) const = 0;
+  virtual void lookup_batch(const std::string_view *strs, size_t size, uint32_t *ids) const = 0;
+  virtual void lookup_sorted_batch(const char *const *strs, size_t size,
+                                   uint32_t *ids) const = 0;
+  virtual void lookup_sorted_batch(const std::string_view *strs, size_t size,
+                                   uint32_t *ids) const = 0;
+  virtual void common_prefix_search(const char *text, size_t length,
+                                    std::vector<match_t> &ret) const = 0;
+  virtual size_t predictive_search(std::string_view prefix,
+                                   const std::function<bool(uint32_t, const std::string &)> &f,
+                                   size_t limit) const = 0;
+  virtual size_t fuzzy_search(std::string_view query, size_t max_distance,
+                              const std::function<bool(uint32_t, const std::string &, size_t)> &f,
+                              size_t limit) const = 0;
+  virtual size_t pattern_search(const Pattern &pattern,
+                                const std::function<bool(uint32_t, const std::string &)> &f,
+                                size_t limit) const = 0;
+  virtual uint32_t lower_bound(std::string_view key) const = 0;
+  virtual uint32_t upper_bound(std::string_view key) const = 0;
+  virtual size_t range(std::string_view lo, std::string_view hi,
+                       const std::function<bool(uint32_t, const std::string &)> &f,
+                       size_t limit) const = 0;
+  virtual size_t count_prefix(std::string_view prefix) const = 0;
+  virtual void build_count_index() = 0;
+  virtual void build_child_index() = 0;
+  virtual void build_weights(const std::vector<uint32_t> &weights) = 0;
+  virtual void build_scanner() = 0;
+  virtual cursor_t cursor_root() const = 0;
+  virtual bool cursor_feed(cursor_t &cursor, char c) const = 0;
+  virtual uint32_t cursor_id(const cursor_t &cursor) const = 0;
+  virtual size_t cursor_predict(const cursor_t &cursor,
+                                const std::function<bool(uint32_t, const std::string &)> &f,
+                                size_t limit) const = 0;
+  virtual void scan(std::string_view text, const std::function<void(const match_t &)> &f) const = 0;
+  virtual void topk_completions(std::string_view prefix, size_t k,
+                                std::vector<weighted_t> &ret) const = 0;
+  virtual match_t longest_prefix_match(const char *str, size_t length) const = 0;
+  virtual void longest_prefix_match_batch(const char *const *strs, const size_t *lengths,
+                                          size_t size, match_t *ret) const = 0;
+  virtual void access(uint32_t str_id, std::string &ret) const = 0;
+  virtual size_t access(uint32_t str_id, char *buf, size_t capacity) const = 0;
+  virtual std::string_view access(uint32_t str_id) const = 0;
+  virtual void access_batch(const uint32_t *str_ids, size_t size, std::string &bytes,
+                            std::vector<size_t> &offsets) const = 0;
+  virtual void enumerate(std::vector<uint32_t> &ret) const = 0;
+  virtual size_t enumerate(const std::function<bool(uint32_t, const std::string &)> &f) const = 0;
+  virtual size_t enumerate(uint32_t &node_pos, size_t size,
+                           const std::function<bool(uint32_t, const std::string &)> &f) const = 0;
+
+  virtual void intersect(const TrieDic &other,
+                         const std::function<void(uint32_t, uint32_t)> &f) const = 0;
+  virtual void difference(const TrieDic &other,
+                          const std::function<void(uint32_t)> &f) const = 0;
+  virtual void merge(const TrieDic &other,
+                     const std::function<void(uint32_t, uint32_t)> &f) const = 0;
+
+  virtual bc_type type() const = 0;
+  virtual id_order order() const = 0;
+  virtual size_t num_strs() const = 0;
+  virtual size_t max_length() const = 0;
+
+  virtual size_t bc_size() const = 0;
+  virtual size_t tail_size() const = 0;
+  virtual size_t size_in_bytes() const = 0;
+  virtual void stat(std::ostream &os) const = 0;
+
+  virtual void write(std::ostream &os) const = 0;
+  virtual void read(std::istream &is) = 0;
+
+  virtual void clear() = 0;
+};
+
+} // cda_tries
+
+#endif // CDA_TRIES_TRIE_DIC_HPP
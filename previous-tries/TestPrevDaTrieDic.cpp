@@ -1,3 +1,5 @@
+#undef NDEBUG
+
 #include <algorithm>
 #include <cassert>
 #include <random>
@@ -45,7 +47,14 @@ void TestTrieDic(const std::vector<std::string> &strs, dic_type type) {
   assert(dic->num_strs() == strs.size());
 
   for (size_t i = 0; i < strs.size(); ++i) {
-    assert(dic->lookup(strs[i].c_str()) != cda_tries::NOT_FOUND);
+    auto str_id = dic->lookup(strs[i].c_str());
+    assert(str_id != cda_tries::NOT_FOUND);
+
+    auto text = strs[i] + strs[i];
+    assert(dic->lookup(text.data(), strs[i].size()) == str_id);
+    assert(dic->lookup(std::string_view(text).substr(0, strs[i].size())) == str_id);
+    assert(dic->lookup(text.data(), strs[i].size() - 1)
+           == dic->lookup(strs[i].substr(0, strs[i].size() - 1).c_str()));
   }
 
   std::vector<std::string> ret;
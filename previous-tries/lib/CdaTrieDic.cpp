@@ -342,6 +342,29 @@ uint32_t CdaTrieDic::lookup(const char *str) const {
   return (*tail == *str) ? to_str_id_(node_pos) : NOT_FOUND;
 }
 
+uint32_t CdaTrieDic::lookup(const char *str, size_t length) const {
+  auto end = str + length;
+  uint32_t node_pos = 0;
+
+  while (!bc_[node_pos].is_leaf()) {
+    if (str == end) {
+      return term_flags_[node_pos] ? to_str_id_(node_pos) : NOT_FOUND;
+    }
+    node_pos = find_child_(node_pos, static_cast<uint8_t>(*str++));
+    if (node_pos == NOT_FOUND) {
+      return NOT_FOUND;
+    }
+  }
+
+  auto tail = &tail_[bc_[node_pos].link()];
+  for (; str != end; ++str, ++tail) {
+    if (*tail == '\0' || *tail != *str) {
+      return NOT_FOUND;
+    }
+  }
+  return (*tail == '\0') ? to_str_id_(node_pos) : NOT_FOUND;
+}
+
 void CdaTrieDic::enumerate(std::vector<std::string> &ret) const {
   ret.clear();
   ret.reserve(num_strs_);
@@ -582,6 +582,29 @@ uint32_t DalfTrieDic::lookup(const char *str) const {
   return (*tail == *str) ? to_str_id_(node_pos) : NOT_FOUND;
 }
 
+uint32_t DalfTrieDic::lookup(const char *str, size_t length) const {
+  auto end = str + length;
+  uint32_t node_pos = 0;
+
+  while (!leaf_flags_[node_pos]) {
+    if (str == end) {
+      return term_flags_[node_pos] ? to_str_id_(node_pos) : NOT_FOUND;
+    }
+    node_pos = find_child_(node_pos, static_cast<uint8_t>(*str++));
+    if (node_pos == NOT_FOUND) {
+      return NOT_FOUND;
+    }
+  }
+
+  auto tail = &tail_[link_(node_pos)];
+  for (; str != end; ++str, ++tail) {
+    if (*tail == '\0' || *tail != *str) {
+      return NOT_FOUND;
+    }
+  }
+  return (*tail == '\0') ? to_str_id_(node_pos) : NOT_FOUND;
+}
+
 void DalfTrieDic::enumerate(std::vector<std::string> &ret) const {
   ret.clear();
   ret.reserve(num_strs_);
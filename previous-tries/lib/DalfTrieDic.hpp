@@ -65,7 +65,9 @@ public:
 
   void build(const std::vector<std::string> &strs);
 
+  using PrevDaTrieDic::lookup;
   uint32_t lookup(const char *str) const;
+  uint32_t lookup(const char *str, size_t length) const;
   void enumerate(std::vector<std::string> &ret) const;
 
   size_t num_strs() const;
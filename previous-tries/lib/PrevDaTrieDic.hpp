@@ -20,6 +20,10 @@ public:
   virtual void build(const std::vector<std::string> &strs) = 0;
 
   virtual uint32_t lookup(const char *str) const = 0;
+  virtual uint32_t lookup(const char *str, size_t length) const = 0;
+  uint32_t lookup(std::string_view str) const {
+    return lookup(str.data(), str.size());
+  }
   virtual void enumerate(std::vector<std::string> &ret) const = 0;
 
   virtual size_t num_strs() const = 0;